@@ -0,0 +1,95 @@
+import argparse
+import sys
+from binascii import crc_hqx
+from itertools import cycle
+from struct import pack, unpack_from
+from serial import Serial
+
+# Dump of s0v4 radio latency histograms (UART command 0x054B).
+# Frame 0x054C carries one span: count, max and bucket counts, times in us.
+#
+#   python latency-dump.py /dev/ttyUSB0
+#   python latency-dump.py /dev/ttyUSB0 --reset
+#   python latency-dump.py /dev/ttyUSB0 --benchmark  (DEBUG build, to log)
+
+KEY_COMM = [22, 108, 20, 230, 46, 145, 13, 64, 33, 53, 213, 64, 19, 3, 233, 128]
+
+CMD_LATENCY = 0x054B
+REPLY_LATENCY = 0x054C
+
+SPANS = ["tune>rssi", "tune>sql", "sql>audio", "step", "render"]
+
+
+def xor(var: bytes):
+    return bytes(a ^ b for a, b in zip(var, cycle(KEY_COMM)))
+
+
+def send_command(port, data: bytes):
+    data2 = data + pack("<H", crc_hqx(data, 0))
+    port.write(pack(">HBB", 0xabcd, len(data), 0) + xor(data2) + pack(">H", 0xdcba))
+
+
+def read_frames(port):
+    """Yields (id, body). Skips debug log text between frames."""
+    while True:
+        b = port.read(1)
+        if not b:
+            return
+        if b[0] != 0xAB or port.read(1) != b"\xcd":
+            continue
+        h = port.read(2)
+        if len(h) != 2:
+            continue
+        size, zero = h
+        body = port.read(size)
+        footer = port.read(4)
+        if zero != 0 or len(body) != size or footer[2:] != b"\xdc\xba":
+            continue
+        body = xor(body)
+        yield unpack_from("<H", body)[0], body
+
+
+def fmt_us(us):
+    return f"{us / 1000:g}ms" if us >= 1000 else f"{us}us"
+
+
+def print_span(name, count, max_us, edges, hist):
+    print(f"{name}: n={count} max={fmt_us(max_us)}")
+    if not count:
+        return
+    top = max(hist) or 1
+    lows = [0] + edges
+    for i, n in enumerate(hist):
+        if not n:
+            continue
+        label = f"<{fmt_us(edges[i])}" if i < len(edges) else f">={fmt_us(lows[i])}"
+        print(f"  {label:>9} {n:6} {'#' * (n * 40 // top)}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="s0v4 latency histograms")
+    parser.add_argument("port")
+    parser.add_argument("--reset", action="store_true",
+                        help="clear histograms after dump")
+    parser.add_argument("--benchmark", action="store_true",
+                        help="run spectrum benchmark after dump")
+    args = parser.parse_args()
+
+    port = Serial(args.port, 38400, timeout=2)
+    send_command(port, pack("<HHBB2x", CMD_LATENCY, 4, args.reset,
+                             args.benchmark))
+
+    for fid, body in read_frames(port):
+        if fid != REPLY_LATENCY:
+            continue
+        span, spans, buckets, count, max_us = unpack_from("<BBBxII", body, 4)
+        edges = list(unpack_from(f"<{buckets - 1}I", body, 16))
+        hist = list(unpack_from(f"<{buckets}H", body, 16 + 4 * (buckets - 1)))
+        name = SPANS[span] if span < len(SPANS) else f"span{span}"
+        print_span(name, count, max_us, edges, hist)
+        if span == spans - 1:
+            break
+
+
+if __name__ == "__main__":
+    sys.exit(main())
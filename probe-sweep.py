@@ -0,0 +1,116 @@
+import argparse
+import sys
+import time
+from binascii import crc_hqx
+from itertools import cycle
+from struct import pack, unpack_from
+from serial import Serial
+
+# Batch measurement over UART (command 0x0548), prints CSV.
+# Frequencies are in MHz, radio works in 10 Hz units.
+#
+#   python probe-sweep.py /dev/ttyUSB0 --range 433 434 0.0125
+#   python probe-sweep.py /dev/ttyUSB0 --list 145.5 433.5 446.00625
+
+KEY_COMM = [22, 108, 20, 230, 46, 145, 13, 64, 33, 53, 213, 64, 19, 3, 233, 128]
+
+CMD_PROBE = 0x0548
+REPLY_PROBE = 0x0549
+FRAME_RECORDS = 0x054A
+
+KEEP = 0xFF
+LIST_MAX = 32
+STATUS = ["ok", "busy", "current VFO is not on BK4819", "bad arguments"]
+
+
+def xor(var: bytes):
+    return bytes(a ^ b for a, b in zip(var, cycle(KEY_COMM)))
+
+
+def send_command(port, data: bytes):
+    data2 = data + pack("<H", crc_hqx(data, 0))
+    port.write(pack(">HBB", 0xabcd, len(data), 0) + xor(data2) + pack(">H", 0xdcba))
+
+
+def read_frames(port):
+    """Yields (id, body). Skips debug log text between frames."""
+    while True:
+        b = port.read(1)
+        if not b:
+            return
+        if b[0] != 0xAB or port.read(1) != b"\xcd":
+            continue
+        h = port.read(2)
+        if len(h) != 2:
+            continue
+        size, zero = h
+        body = port.read(size)
+        footer = port.read(4)
+        if zero != 0 or len(body) != size or footer[2:] != b"\xdc\xba":
+            continue
+        body = xor(body)
+        yield unpack_from("<H", body)[0], body
+
+
+def to_f(mhz):
+    return round(mhz * 100000)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="s0v4 batch measurement")
+    parser.add_argument("port")
+    mode = parser.add_mutually_exclusive_group(required=True)
+    mode.add_argument("--range", nargs=3, type=float,
+                      metavar=("START", "END", "STEP"))
+    mode.add_argument("--list", nargs="+", type=float)
+    parser.add_argument("--settle", type=int, default=1000, help="us")
+    parser.add_argument("--bw", type=int, default=KEEP)
+    parser.add_argument("--gain", type=int, default=KEEP)
+    parser.add_argument("--precise", action="store_true",
+                        help="VCO calibration on every tune")
+    args = parser.parse_args()
+
+    freqs = []
+    if args.range:
+        start, end, step = map(to_f, args.range)
+        count = (end - start) // step + 1
+    else:
+        freqs = [to_f(f) for f in args.list[:LIST_MAX]]
+        start, step, count = 0, 0, 0
+
+    payload = pack("<IIHHBBBB", start, step, count, args.settle, args.bw,
+                   args.gain, args.precise, len(freqs))
+    payload += b"".join(pack("<I", f) for f in freqs)
+
+    port = Serial(args.port, 38400, timeout=2)
+    send_command(port, pack("<HH", CMD_PROBE, len(payload)) + payload)
+
+    print("f,rssi,noise,glitch,snr,open")
+    try:
+        for fid, body in read_frames(port):
+            if fid == REPLY_PROBE:
+                status, n = unpack_from("<BxH", body, 4)
+                if status:
+                    sys.exit(f"Rejected: {STATUS[status]}")
+                print(f"# {n} points", file=sys.stderr)
+                continue
+            if fid != FRAME_RECORDS:
+                continue
+
+            index, n, last, elapsed = unpack_from("<HBBI", body, 4)
+            for i in range(n):
+                f, rssi, noise, glitch, snr, sq = unpack_from("<IHBBBB", body,
+                                                              12 + i * 10)
+                print(f"{f / 100000:.5f},{rssi},{noise},{glitch},{snr},{sq}")
+            if last:
+                total = index + n
+                rate = total * 1000 / elapsed if elapsed else 0
+                print(f"# {total} points in {elapsed} ms, {rate:.0f}/s",
+                      file=sys.stderr)
+                break
+    except KeyboardInterrupt:
+        send_command(port, pack("<HH", CMD_PROBE, 20) + bytes(20))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,90 @@
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+# RAM usage per module from linker map (.data, .bss, COMMON).
+# LTO merges modules, so build with `make ram` for per-symbol sections.
+#
+#   python ram-report.py obj/output.map
+#   python ram-report.py obj/output.map --symbols 20
+
+RAM_START = 0x20000000
+RAM_SIZE = 16 * 1024
+
+SECTION = re.compile(r"^ (\.data|\.bss|COMMON)(\.\S+)?\s*$")
+ENTRY = re.compile(r"^ (\.data|\.bss|COMMON)(\.\S+)?\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S+)")
+CONT = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S+)")
+
+
+def parse(path):
+    """Yields (object, symbol, size) for every RAM input section."""
+    in_map = False
+    pending = None
+    with open(path) as f:
+        for line in f:
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+            m = ENTRY.match(line)
+            if m:
+                kind, name, addr, size, obj = m.groups()
+                pending = None
+            elif pending:
+                m = CONT.match(line)
+                pending, (kind, name) = None, pending
+                if not m:
+                    continue
+                addr, size, obj = m.groups()
+            else:
+                m = SECTION.match(line)
+                if m:
+                    pending = m.groups()
+                continue
+            addr, size = int(addr, 16), int(size, 16)
+            if not size or addr < RAM_START or addr >= RAM_START + RAM_SIZE:
+                continue
+            sym = name[1:] if name else kind
+            yield obj, sym, size
+
+
+def module(obj):
+    obj = obj.split("(")[0]
+    return obj[4:] if obj.startswith("obj/") else obj
+
+
+def main():
+    parser = argparse.ArgumentParser(description="s0v4 RAM usage report")
+    parser.add_argument("map", nargs="?", default="obj/output.map")
+    parser.add_argument("--symbols", type=int, default=10,
+                        help="largest symbols to list")
+    args = parser.parse_args()
+
+    modules = defaultdict(int)
+    symbols = []
+    for obj, sym, size in parse(args.map):
+        modules[module(obj)] += size
+        symbols.append((size, sym.removeprefix("bss.").removeprefix("data."),
+                        module(obj)))
+
+    if not symbols:
+        sys.exit("No RAM sections found")
+
+    total = sum(modules.values())
+    print(f"{'module':<40} {'bytes':>6}")
+    for name, size in sorted(modules.items(), key=lambda m: -m[1]):
+        print(f"{name:<40} {size:>6}")
+    print(f"{'total':<40} {total:>6}  ({total * 100 / RAM_SIZE:.1f}% of "
+          f"{RAM_SIZE}, main stack excluded)")
+
+    print()
+    for size, sym, name in sorted(symbols, reverse=True)[:args.symbols]:
+        print(f"{sym:<30} {name:<20} {size:>6}")
+
+    arena = [s for s in symbols if s[1] == "arena" and "apps" in s[2]]
+    if arena:
+        print(f"\napps arena {arena[0][0]} B, shared by foreground apps")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
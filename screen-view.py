@@ -0,0 +1,123 @@
+import argparse
+import sys
+from binascii import crc_hqx
+from itertools import cycle
+from struct import pack, unpack_from
+from serial import Serial
+
+# Mirror of s0v4 display (UART command 0x0545).
+# Frame 0x0547 carries one changed 128x8 page, raw or RLE packed.
+#
+#   python screen-view.py /dev/ttyUSB0 --interval 200
+
+KEY_COMM = [22, 108, 20, 230, 46, 145, 13, 64, 33, 53, 213, 64, 19, 3, 233, 128]
+
+CMD_MIRROR = 0x0545
+REPLY_MIRROR = 0x0546
+FRAME_PAGE = 0x0547
+
+SCREEN_RAW = 0
+SCREEN_RLE = 1
+
+W = 128
+PAGES = 8
+
+
+def xor(var: bytes):
+    return bytes(a ^ b for a, b in zip(var, cycle(KEY_COMM)))
+
+
+def send_command(port, data: bytes):
+    data2 = data + pack("<H", crc_hqx(data, 0))
+    port.write(pack(">HBB", 0xabcd, len(data), 0) + xor(data2) + pack(">H", 0xdcba))
+
+
+def set_mirror(port, enable, interval_ms):
+    send_command(port, pack("<HHBxH", CMD_MIRROR, 4, enable, interval_ms))
+
+
+def read_frames(port):
+    """Yields (id, body, bytes on wire). Skips debug log text between frames."""
+    while True:
+        b = port.read(1)
+        if not b:
+            continue
+        if b[0] != 0xAB or port.read(1) != b"\xcd":
+            continue
+        h = port.read(2)
+        if len(h) != 2:
+            continue
+        size, zero = h
+        body = port.read(size)
+        footer = port.read(4)
+        if zero != 0 or len(body) != size or footer[2:] != b"\xdc\xba":
+            continue
+        body = xor(body)
+        yield unpack_from("<H", body)[0], body, size + 8
+
+
+def unpack_page(encoding, data):
+    if encoding == SCREEN_RAW:
+        return data
+    out = bytearray()
+    for i in range(0, len(data) - 1, 2):
+        out += bytes([data[i + 1]]) * data[i]
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="s0v4 screen mirror")
+    parser.add_argument("port")
+    parser.add_argument("--interval", type=int, default=0,
+                        help="min ms between frames (0: firmware default)")
+    args = parser.parse_args()
+
+    import matplotlib.pyplot as plt
+
+    port = Serial(args.port, 38400, timeout=1)
+    set_mirror(port, True, args.interval)
+
+    pixels = [[0] * W for _ in range(PAGES * 8)]
+    plt.ion()
+    fig, ax = plt.subplots()
+    img = ax.imshow(pixels, cmap="Greys", vmin=0, vmax=1, interpolation="nearest")
+    ax.set_axis_off()
+
+    frames = 0
+    wire = 0
+    seq = None
+    try:
+        for fid, body, size in read_frames(port):
+            if fid == REPLY_MIRROR:
+                enabled, interval, nf, npages, nbytes, deferred = \
+                    unpack_from("<BxHIIII", body, 4)
+                print(f"mirror={enabled} interval={interval}ms frames={nf} "
+                      f"pages={npages} bytes={nbytes} deferred={deferred}")
+                continue
+            if fid != FRAME_PAGE:
+                continue
+
+            fseq, page, encoding, n = unpack_from("<HBBB", body, 4)
+            data = unpack_page(encoding, body[12:12 + n])
+            if len(data) != W or page >= PAGES:
+                continue
+            for x, v in enumerate(data):
+                for bit in range(8):
+                    pixels[page * 8 + bit][x] = (v >> bit) & 1
+
+            wire += size
+            if fseq != seq:
+                seq = fseq
+                frames += 1
+            img.set_data(pixels)
+            ax.set_title(f"#{fseq} {wire / frames:.0f} B/frame")
+            fig.canvas.draw_idle()
+            plt.pause(0.001)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        set_mirror(port, False, 0)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
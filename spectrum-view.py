@@ -0,0 +1,125 @@
+import argparse
+import sys
+import time
+from binascii import crc_hqx
+from itertools import cycle
+from struct import pack, unpack_from
+from serial import Serial
+
+# Live view of spectrum sweeps streamed by s0v4 (UART command 0x0542).
+# Frame 0x0544: timestamp, band edges, step, RSSI/2 per column.
+#
+#   python spectrum-view.py /dev/ttyUSB0
+#   python spectrum-view.py /dev/ttyUSB0 --log sweeps.csv --no-plot
+
+KEY_COMM = [22, 108, 20, 230, 46, 145, 13, 64, 33, 53, 213, 64, 19, 3, 233, 128]
+
+CMD_STREAM = 0x0542
+REPLY_STREAM = 0x0543
+FRAME_SPECTRUM = 0x0544
+
+
+def xor(var: bytes):
+    return bytes(a ^ b for a, b in zip(var, cycle(KEY_COMM)))
+
+
+def send_command(port, data: bytes):
+    data2 = data + pack("<H", crc_hqx(data, 0))
+    port.write(pack(">HBB", 0xabcd, len(data), 0) + xor(data2) + pack(">H", 0xdcba))
+
+
+def set_stream(port, enable):
+    send_command(port, pack("<HHB3x", CMD_STREAM, 4, enable))
+
+
+def read_frames(port):
+    """Yields (id, body). Skips debug log text between frames."""
+    while True:
+        b = port.read(1)
+        if not b:
+            continue
+        if b[0] != 0xAB or port.read(1) != b"\xcd":
+            continue
+        h = port.read(2)
+        if len(h) != 2:
+            continue
+        size, zero = h
+        body = port.read(size)
+        footer = port.read(4)
+        if zero != 0 or len(body) != size or footer[2:] != b"\xdc\xba":
+            continue
+        body = xor(body)
+        yield unpack_from("<H", body)[0], body
+
+
+def parse_spectrum(body):
+    ts, fs, fe, step, seq, count = unpack_from("<IIIIHB", body, 4)
+    rssi = [v - 160 for v in body[24:24 + count]]
+    return ts, fs, fe, step, seq, rssi
+
+
+def main():
+    parser = argparse.ArgumentParser(description="s0v4 spectrum stream viewer")
+    parser.add_argument("port")
+    parser.add_argument("--log", help="append sweeps to CSV file")
+    parser.add_argument("--no-plot", action="store_true")
+    args = parser.parse_args()
+
+    port = Serial(args.port, 38400, timeout=1)
+    set_stream(port, True)
+
+    log = open(args.log, "a") if args.log else None
+
+    plt = None
+    if not args.no_plot:
+        import matplotlib.pyplot as plt
+        plt.ion()
+        fig, ax = plt.subplots()
+        line, = ax.plot([], [])
+        ax.set_xlabel("MHz")
+        ax.set_ylabel("dBm")
+        ax.set_ylim(-160, -20)
+
+    last_seq = None
+    lost = 0
+    try:
+        for fid, body in read_frames(port):
+            if fid == REPLY_STREAM:
+                enabled, cost, frames, dropped = unpack_from("<BxHII", body, 4)
+                print(f"stream={enabled} frames={frames} dropped={dropped} "
+                      f"max cost={cost / 10}ms")
+                continue
+            if fid != FRAME_SPECTRUM:
+                continue
+
+            ts, fs, fe, step, seq, rssi = parse_spectrum(body)
+            if last_seq is not None and seq != (last_seq + 1) & 0xFFFF:
+                lost += (seq - last_seq - 1) & 0xFFFF
+            last_seq = seq
+
+            if log:
+                log.write(f"{time.time():.3f},{ts},{seq},{fs},{fe},{step},"
+                          + ",".join(map(str, rssi)) + "\n")
+                log.flush()
+
+            if plt:
+                n = max(len(rssi) - 1, 1)
+                xs = [(fs + (fe - fs) * i / n) / 100000 for i in range(len(rssi))]
+                line.set_data(xs, rssi)
+                ax.set_xlim(fs / 100000, fe / 100000)
+                ax.set_title(f"#{seq} {ts / 1000:.1f}s lost={lost}")
+                fig.canvas.draw_idle()
+                plt.pause(0.001)
+            else:
+                print(f"#{seq} {fs / 100000:.5f}-{fe / 100000:.5f} MHz "
+                      f"max={max(rssi, default=-160)} dBm lost={lost}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        set_stream(port, False)
+        if log:
+            log.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
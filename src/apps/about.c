@@ -1,4 +1,6 @@
 #include "about.h"
+#include "../svc.h"
+#include "../system.h"
 #include "../ui/graphics.h"
 #include "apps.h"
 
@@ -6,6 +8,21 @@ void ABOUT_Render() {
   PrintMediumEx(LCD_XCENTER, LCD_YCENTER - 8, POS_C, C_FILL, "s0v4");
   PrintSmallEx(LCD_XCENTER, LCD_YCENTER, POS_C, C_FILL, "FAGCI & Tiger");
   PrintSmallEx(LCD_XCENTER, LCD_YCENTER + 8, POS_C, C_FILL, TIME_STAMP);
+
+  // background services cpu share, last second
+  const uint8_t svcW = LCD_WIDTH / SVC_COUNT;
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    PrintSmallEx(svcW * i + svcW / 2, LCD_YCENTER + 16, POS_C, C_FILL,
+                 "%s %u%%", SVC_GetName(i), SVC_GetLoad(i));
+  }
+
+  // boot profile, ms since start when stage was done
+  const uint8_t colW = LCD_WIDTH / BOOT_STAGE_COUNT;
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; ++i) {
+    const uint8_t x = colW * i + colW / 2;
+    PrintSmallEx(x, LCD_HEIGHT - 8, POS_C, C_FILL, bootStageNames[i]);
+    PrintSmallEx(x, LCD_HEIGHT - 2, POS_C, C_FILL, "%u", gBootMs[i]);
+  }
 }
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
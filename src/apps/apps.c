@@ -1,14 +1,17 @@
 #include "apps.h"
 #include "../driver/st7565.h"
+#include "../driver/uart.h"
 #include "../ui/graphics.h"
 #include "../ui/statusline.h"
 #include "about.h"
 #include "appslist.h"
+#include "bcscan.h"
 #include "chcfg.h"
 #include "chlist.h"
 #include "chscan.h"
 #include "fc.h"
 #include "finput.h"
+#include "latview.h"
 // #include "generator.h"
 #include "lootlist.h"
 // #include "memview.h"
@@ -19,6 +22,7 @@
 #include "vfo1.h"
 #include "vfo2.h"
 #include "morse.h"
+#include <string.h>
 
 #define APPS_STACK_SIZE 8
 
@@ -27,6 +31,13 @@ AppType_t gCurrentApp = APP_NONE;
 static AppType_t appsStack[APPS_STACK_SIZE] = {APP_NONE};
 static int8_t stackIndex = -1;
 
+// Working state of foreground app, claimed from its init and gone on its
+// deinit, so apps rebuild it in init and keep only plain data there.
+// Input overlays don't claim: app below them keeps its state.
+static uint32_t arena[APPS_ARENA_SIZE / sizeof(uint32_t)];
+static uint16_t arenaUsed;
+static AppType_t arenaOwner = APP_NONE;
+
 static bool pushApp(AppType_t app) {
   if (stackIndex < APPS_STACK_SIZE - 1) {
     appsStack[++stackIndex] = app;
@@ -60,11 +71,13 @@ const AppType_t appsAvailableToRun[RUN_APPS_COUNT] = {
     APP_SCANER,    //
     APP_CH_SCAN,   //
     APP_FC,        //
+    APP_BC_SCAN,   //
     APP_LOOT_LIST, //
     // APP_MEMVIEW,   //
     // APP_GENERATOR, //
     APP_RESET,
     APP_MORSE,     //
+    APP_LATENCY,   //
     APP_ABOUT,     //
 };
 
@@ -73,10 +86,9 @@ const App apps[APPS_COUNT] = {
     // {"EEPROM view", MEMVIEW_Init, NULL, MEMVIEW_Render, MEMVIEW_key, NULL},
     {"Spectrum", SCANER_init, SCANER_update, SCANER_render, SCANER_key,
      SCANER_deinit},
-    {"CH Scan", CHSCAN_init, CHSCAN_update, CHSCAN_render, CHSCAN_key,
-     CHSCAN_deinit},
-    {"FC", FC_init, FC_update, FC_render, FC_key, FC_deinit},
-    {"Channels", CHLIST_init, NULL, CHLIST_render, CHLIST_key, CHLIST_deinit},
+    {"CH Scan", CHSCAN_init, NULL, CHSCAN_render, CHSCAN_key, CHSCAN_deinit},
+    {"FC", FC_init, NULL, FC_render, FC_key, FC_deinit},
+    {"Channels", CHLIST_init, CHLIST_update, CHLIST_render, CHLIST_key, CHLIST_deinit},
     {"Freq input", FINPUT_init, FINPUT_update, FINPUT_render, FINPUT_key,
      FINPUT_deinit},
     {"Run app", APPSLIST_init, NULL, APPSLIST_render, APPSLIST_key, NULL},
@@ -93,6 +105,8 @@ const App apps[APPS_COUNT] = {
     //  GENERATOR_key, NULL},
     {"Morse", MORSE_init, MORSE_update, MORSE_render, MORSE_key, MORSE_deinit},
     {"ABOUT", NULL, NULL, ABOUT_Render, ABOUT_key, NULL},
+    {"BC Scan", BCSCAN_init, NULL, BCSCAN_render, BCSCAN_key, BCSCAN_deinit},
+    {"Latency", NULL, LATVIEW_update, LATVIEW_render, LATVIEW_key, NULL},
 };
 
 bool APPS_key(KEY_Code_t Key, Key_State_t state) {
@@ -132,6 +146,27 @@ void APPS_deinit(void) {
   if (apps[gCurrentApp].deinit) {
     apps[gCurrentApp].deinit();
   }
+  if (arenaOwner == gCurrentApp) {
+    arenaOwner = APP_NONE;
+    arenaUsed = 0;
+  }
+}
+
+void *APPS_Claim(uint16_t size) {
+  if (arenaOwner != gCurrentApp) {
+    arenaOwner = gCurrentApp;
+    arenaUsed = 0;
+  }
+  size = (size + 3) & ~3;
+  if (arenaUsed + size > APPS_ARENA_SIZE) {
+    Log("ARENA %s %u+%u>%u", apps[gCurrentApp].name, arenaUsed, size,
+        APPS_ARENA_SIZE);
+    return NULL;
+  }
+  uint8_t *p = (uint8_t *)arena + arenaUsed;
+  arenaUsed += size;
+  memset(p, 0, size);
+  return p;
 }
 
 void APPS_run(AppType_t app) {
@@ -3,8 +3,9 @@
 
 #include "../driver/keyboard.h"
 
-#define APPS_COUNT 16
-#define RUN_APPS_COUNT 10
+#define APPS_COUNT 18
+#define RUN_APPS_COUNT 12
+#define APPS_ARENA_SIZE 512
 
 typedef enum {
   APP_NONE,
@@ -25,6 +26,8 @@ typedef enum {
   // APP_GENERATOR,
   APP_MORSE,
   APP_ABOUT,
+  APP_BC_SCAN, // appended, gSettings.mainApp stores these values
+  APP_LATENCY,
 } AppType_t;
 
 typedef struct App {
@@ -49,5 +52,6 @@ void APPS_render(void);
 void APPS_run(AppType_t app);
 void APPS_runManual(AppType_t app);
 bool APPS_exit(void);
+void *APPS_Claim(uint16_t size);
 
 #endif /* end of include guard: APPS_H */
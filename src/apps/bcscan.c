@@ -0,0 +1,263 @@
+#include "bcscan.h"
+#include "../driver/bk1080.h"
+#include "../driver/si473x.h"
+#include "../driver/uart.h"
+#include "../helper/bands.h"
+#include "../helper/lootlist.h"
+#include "../helper/measurements.h"
+#include "../helper/rds.h"
+#include "../radio.h"
+#include "../scheduler.h"
+#include "../svc.h"
+#include "../ui/components.h"
+#include "../ui/graphics.h"
+
+// Broadcast discovery on BK1080/SI4732. Chip seeks to next station by
+// itself and raises STC, service only polls status, so a pass costs one
+// seek per station instead of tune and settle per step. Stations go to
+// loot, SI4732 FM ones are held until RDS PS is read or it times out.
+
+#define POLL_MS 10
+#define TUNE_MS 80 // tune to band start is done
+#define RDS_POLL_MS 40
+#define RDS_SYNC_MS 300 // no sync by then: station has no RDS
+#define RDS_MAX_MS 1500
+#define PASS_PAUSE_MS 1000
+
+typedef enum {
+  BC_PASS,
+  BC_TUNE,
+  BC_SEEK,
+  BC_RDS,
+} BcState;
+
+static BcState state;
+static uint32_t bandE;
+static uint32_t f;
+static uint16_t rssi;
+static uint8_t snr;
+static uint32_t rdsStart;
+
+static uint16_t passes;
+static uint8_t found;
+static uint8_t lastFound;
+static uint32_t passStart;
+static uint32_t passMs;
+
+static bool supported(void) {
+  const Radio r = RADIO_GetRadio();
+  return r == RADIO_BK1080 || (r == RADIO_SI4732 && !RADIO_IsSSB());
+}
+
+static bool isSi(void) { return RADIO_GetRadio() == RADIO_SI4732; }
+
+static uint32_t step(void) { return StepFrequencyTable[gCurrentBand.step]; }
+
+static void tuneFrom(uint32_t from) {
+  if (isSi()) {
+    SI47XX_TuneTo(from);
+  } else {
+    BK1080_SetFrequency(from);
+  }
+  f = from;
+  state = BC_TUNE;
+}
+
+static void startPass(void) {
+  const uint32_t s = gCurrentBand.rxF;
+  bandE = gCurrentBand.txF;
+  if (isSi()) {
+    if (RADIO_GetModulation() == MOD_AM) {
+      SI47XX_SetSeekAmLimits(s, bandE);
+      SI47XX_SetSeekAmSpacing(step());
+    } else {
+      SI47XX_SetSeekFmLimits(s, bandE);
+      SI47XX_SetSeekFmSpacing(step());
+    }
+  }
+  found = 0;
+  passStart = Now();
+  tuneFrom(s);
+}
+
+static void seek(void) {
+  if (isSi()) {
+    SI47XX_Seek(true, false);
+  } else {
+    BK1080_Seek();
+  }
+  state = BC_SEEK;
+}
+
+static void setOpen(bool open) {
+  Measurement m = {.f = f, .rssi = rssi, .snr = snr, .open = open};
+  LOOT_Update(&m);
+}
+
+static void endPass(void) {
+  passMs = Now() - passStart;
+  lastFound = found;
+  passes++;
+  Log("BC pass %u: %u stations in %ums", passes, found, passMs);
+  state = BC_PASS;
+  gRedrawScreen = true;
+}
+
+static uint16_t seekPoll(void) {
+  bool limit;
+  bool valid = true;
+  if (isSi()) {
+    SI47XX_SeekResult r;
+    if (!SI47XX_SeekDone(&r)) {
+      return POLL_MS;
+    }
+    f = r.f;
+    limit = r.limit;
+    valid = r.valid;
+    rssi = ConvertDomain(r.rssi, 0, 64, 30, 346);
+    snr = r.snr;
+  } else {
+    if (!BK1080_SeekDone(&f, &limit)) {
+      return POLL_MS;
+    }
+    rssi = BK1080_GetRSSI();
+    snr = BK1080_GetSNR();
+  }
+
+  if (limit && f + step() <= bandE) {
+    tuneFrom(f + step()); // BK1080 sub-band edge (76 MHz)
+    return TUNE_MS;
+  }
+  if (limit || f > bandE) {
+    endPass();
+    return PASS_PAUSE_MS;
+  }
+  if (!valid) {
+    seek();
+    return POLL_MS;
+  }
+
+  setOpen(true);
+  found++;
+  gRedrawScreen = true;
+  if (isSi() && RADIO_GetModulation() == MOD_FM) {
+    RDS_Reset();
+    rdsStart = Now();
+    state = BC_RDS;
+    return RDS_POLL_MS;
+  }
+  setOpen(false);
+  seek();
+  return POLL_MS;
+}
+
+static uint16_t rdsPoll(void) {
+  if (RDS_Poll()) {
+    gRedrawScreen = true;
+  }
+  const uint32_t t = Now() - rdsStart;
+  if (!RDS_PsReady() && t < RDS_MAX_MS && (gRDS.sync || t < RDS_SYNC_MS)) {
+    return RDS_POLL_MS;
+  }
+  if (gRDS.pi) {
+    Log("BC %u.%05u PI %04X PS %s", f / MHZ, f % MHZ, gRDS.pi, gRDS.ps);
+  }
+  setOpen(false);
+  seek();
+  return POLL_MS;
+}
+
+void BCSCAN_svcInit(void) {
+  state = BC_PASS;
+  passes = 0;
+  lastFound = 0;
+  passMs = 0;
+  RDS_Reset();
+}
+
+uint16_t BCSCAN_svcUpdate(void) {
+  if (!supported()) {
+    return PASS_PAUSE_MS;
+  }
+  switch (state) {
+  case BC_PASS:
+    startPass();
+    return TUNE_MS;
+  case BC_TUNE:
+    seek();
+    return POLL_MS;
+  case BC_SEEK:
+    return seekPoll();
+  case BC_RDS:
+    return rdsPoll();
+  }
+  return POLL_MS;
+}
+
+void BCSCAN_svcDeinit(void) {
+  if (state == BC_RDS) {
+    setOpen(false);
+  }
+  if (state == BC_SEEK && supported()) {
+    if (isSi()) {
+      SI47XX_SeekCancel();
+    } else {
+      BK1080_SeekCancel();
+    }
+  }
+  RADIO_TuneToPure(radio->rxF, true);
+}
+
+void BCSCAN_init(void) {
+  if (supported()) {
+    SVC_Start(SVC_BCSCAN);
+  }
+}
+
+void BCSCAN_deinit(void) {}
+
+bool BCSCAN_key(KEY_Code_t Key, Key_State_t state) {
+  if (state == KEY_RELEASED) {
+    switch (Key) {
+    case KEY_5:
+      if (supported()) {
+        SVC_Toggle(SVC_BCSCAN, !SVC_Running(SVC_BCSCAN));
+      }
+      return true;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+void BCSCAN_render(void) {
+  if (!supported()) {
+    PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL, "No BC radio");
+    PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "Set VFO to FM/AM band");
+    return;
+  }
+  if (!SVC_Running(SVC_BCSCAN)) {
+    PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL, "Stopped");
+    PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "5: start");
+    return;
+  }
+  PrintSmallEx(0, 12, POS_L, C_FILL, "%s", gCurrentBand.name);
+  PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "CPU %u%%",
+               SVC_GetLoad(SVC_BCSCAN));
+  PrintMediumEx(LCD_XCENTER, 22, POS_C, C_FILL,
+                state == BC_RDS ? "RDS..." : "Seeking...");
+
+  UI_BigFrequency(40, f);
+
+  if (gRDS.pi) {
+    PrintSmallEx(LCD_XCENTER, 48, POS_C, C_FILL, "%04X %s", gRDS.pi,
+                 gRDS.ps);
+  }
+
+  PrintSmallEx(0, LCD_HEIGHT - 2, POS_L, C_FILL, "Found %u", found);
+  if (passes) {
+    PrintSmallEx(LCD_WIDTH, LCD_HEIGHT - 2, POS_R, C_FILL, "Last %u in %ums",
+                 lastFound, passMs);
+  }
+}
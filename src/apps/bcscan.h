@@ -0,0 +1,17 @@
+#ifndef BCSCAN_H
+#define BCSCAN_H
+
+#include "../driver/keyboard.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+bool BCSCAN_key(KEY_Code_t Key, Key_State_t state);
+void BCSCAN_init(void);
+void BCSCAN_deinit(void);
+void BCSCAN_render(void);
+
+void BCSCAN_svcInit(void);
+uint16_t BCSCAN_svcUpdate(void);
+void BCSCAN_svcDeinit(void);
+
+#endif /* end of include guard: BCSCAN_H */
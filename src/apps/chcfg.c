@@ -1,5 +1,6 @@
 #include "chcfg.h"
 #include "../dcs.h"
+#include "../driver/eeprom.h"
 #include "../driver/st7565.h"
 #include "../driver/uart.h"
 #include "../helper/measurements.h"
@@ -17,6 +18,8 @@
 static uint8_t menuIndex = 0;
 static uint8_t subMenuIndex = 0;
 static bool isSubMenu = false;
+static bool sessionOpen = false;
+static uint32_t pageWritesAtOpen;
 
 CH gChEd;
 int16_t gChNum = -1;
@@ -76,9 +79,9 @@ static uint8_t menuSize = 0;
 static void apply() {
   switch (gChEd.meta.type) {
   case TYPE_VFO:
+    // saved once on exit
     gVFO[gSettings.activeVFO] = gChEd;
     RADIO_SetupByCurrentVFO();
-    RADIO_SaveCurrentVFO();
     break;
   case TYPE_CH:
     break;
@@ -444,7 +447,32 @@ static void getSubmenuItemText(uint16_t index, char *name) {
   }
 }
 
+// writes only the byte span that differs from stored record
+static void commit(void) {
+  CH stored;
+  CHANNELS_Load(gChNum, &stored);
+  const uint8_t *a = (const uint8_t *)&stored;
+  const uint8_t *b = (const uint8_t *)&gChEd;
+  int8_t first = -1, last = -1;
+  for (uint8_t i = 0; i < CH_SIZE; ++i) {
+    if (a[i] != b[i]) {
+      if (first < 0) {
+        first = i;
+      }
+      last = i;
+    }
+  }
+  if (first >= 0) {
+    CHANNELS_SaveField(gChNum, &gChEd, first, last - first + 1);
+  }
+}
+
 void CHCFG_init(void) {
+  if (!sessionOpen) {
+    sessionOpen = true;
+    pageWritesAtOpen = gEepromStats.pageWrites;
+  }
+
   if (gChEd.meta.type == TYPE_BAND) {
     menu = menuBand;
     menuSize = ARRAY_SIZE(menuBand);
@@ -467,6 +495,9 @@ void CHCFG_deinit(void) {
     RADIO_SaveCurrentVFO();
   }
   gChNum = -1;
+  sessionOpen = false;
+  Log("CHCFG EEPROM page writes: %u",
+      gEepromStats.pageWrites - pageWritesAtOpen);
 }
 
 static bool accept(void) {
@@ -495,7 +526,7 @@ static bool accept(void) {
     return true;
   case M_SAVE:
     if (gChNum >= 0) { // editing existing channel
-      CHANNELS_Save(gChNum, &gChEd);
+      commit();
       APPS_exit();
       return true;
     }
@@ -59,38 +59,114 @@ static const Symbol typeIcons[] = {
 };
 
 static inline uint16_t getChannelNumber(uint16_t menuIndex) {
-  return gScanlist[menuIndex];
+  return CHANNELS_ScanlistAt(menuIndex);
+}
+
+// Decoded rows around cursor, slot = list index % ROWS_WINDOW.
+// Render fills misses, update prefetches one page ahead of scroll direction.
+#define ROWS_WINDOW 16
+#define ROWS_PAGE (MENU_LINES_TO_SHOW + 1)
+
+typedef struct {
+  int16_t index; // list index, -1: empty
+  uint16_t num;
+  CHMeta meta;
+  bool allowTx;
+  uint16_t scanlists;
+  char name[10];
+  uint32_t rxF;
+  uint32_t txF;
+} Row;
+
+_Static_assert(sizeof(Row) * ROWS_WINDOW <= APPS_ARENA_SIZE, "rows window");
+
+static Row *rows; // app state
+static uint16_t rowsRevision;
+static int8_t scrollDir = 1;
+static uint16_t rowsHit, rowsMiss;
+
+static void rowsInvalidate(void) {
+  for (uint8_t i = 0; i < ROWS_WINDOW; ++i) {
+    rows[i].index = -1;
+  }
+  rowsRevision = gChannelsRevision;
+}
+
+static bool rowGet(uint16_t index, Row *out) {
+  bool found = false;
+  taskENTER_CRITICAL();
+  if (rowsRevision != gChannelsRevision) {
+    rowsInvalidate();
+  }
+  const Row *r = &rows[index % ROWS_WINDOW];
+  if (r->index == index) {
+    *out = *r;
+    found = true;
+  }
+  taskEXIT_CRITICAL();
+  return found;
+}
+
+static void rowLoad(uint16_t index, Row *out) {
+  const uint16_t rev = gChannelsRevision;
+  CH c;
+  out->num = getChannelNumber(index);
+  CHANNELS_Load(out->num, &c);
+  out->index = index;
+  out->meta = c.meta;
+  out->allowTx = c.allowTx;
+  out->scanlists = c.scanlists;
+  memcpy(out->name, c.name, sizeof(out->name));
+  out->rxF = c.rxF;
+  out->txF = c.txF;
+
+  taskENTER_CRITICAL();
+  if (rev == gChannelsRevision) {
+    rows[index % ROWS_WINDOW] = *out;
+  }
+  taskEXIT_CRITICAL();
+}
+
+static uint16_t pageOffset(void) {
+  const uint16_t size = gScanlistSize;
+  const uint16_t n = size < ROWS_PAGE ? size : ROWS_PAGE;
+  return Clamp(channelIndex - 2, 0, size - n);
 }
 
 static void getChItem(uint16_t i, uint16_t index, bool isCurrent) {
-  index = getChannelNumber(index);
-  CHANNELS_Load(index, &ch);
+  Row row;
+  if (rowGet(index, &row)) {
+    rowsHit++;
+  } else {
+    rowLoad(index, &row);
+    rowsMiss++;
+  }
   const uint8_t y = MENU_Y + i * MENU_ITEM_H;
   if (isCurrent) {
     FillRect(0, y, LCD_WIDTH - 3, MENU_ITEM_H, C_FILL);
   }
-  if (ch.meta.type) {
-    PrintSymbolsEx(2, y + 8, POS_L, C_INVERT, "%c", typeIcons[ch.meta.type]);
-    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "%s", ch.name);
+  if (row.meta.type) {
+    PrintSymbolsEx(2, y + 8, POS_L, C_INVERT, "%c", typeIcons[row.meta.type]);
+    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "%s", row.name);
   } else {
-    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "CH-%u", index);
+    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "CH-%u", row.num);
   }
   switch (viewMode) {
   case MODE_INFO:
-    if (CHANNELS_IsFreqable(ch.meta.type)) {
+    if (CHANNELS_IsFreqable(row.meta.type)) {
       PrintSmallEx(LCD_WIDTH - 5, y + 8, POS_R, C_INVERT, "%u.%03u %u.%03u",
-                   ch.rxF / MHZ, ch.rxF / 100 % 1000, ch.txF / MHZ,
-                   ch.txF / 100 % 1000);
+                   row.rxF / MHZ, row.rxF / 100 % 1000, row.txF / MHZ,
+                   row.txF / 100 % 1000);
     }
     break;
   case MODE_SCANLIST:
-    if (CHANNELS_IsScanlistable(ch.meta.type)) {
-      UI_Scanlists(LCD_WIDTH - 32, y + 3, ch.scanlists);
+    if (CHANNELS_IsScanlistable(row.meta.type)) {
+      UI_Scanlists(LCD_WIDTH - 32, y + 3, row.scanlists);
     }
     break;
   case MODE_TX:
     PrintSmallEx(LCD_WIDTH - 5, y + 7, POS_R, C_INVERT, "%s",
-                 ch.allowTx ? "ON" : "OFF");
+                 row.allowTx ? "ON" : "OFF");
     break;
     /* case MODE_SELECT:
       break;
@@ -106,7 +182,10 @@ static void save() {
   if (gChEd.meta.type == TYPE_VFO) {
     gChEd.meta.type = TYPE_CH;
   }
-  CHANNELS_Save(getChannelNumber(channelIndex), &gChEd);
+  const uint16_t num = getChannelNumber(channelIndex);
+  if (num < SCANLIST_MAX) {
+    CHANNELS_Save(num, &gChEd);
+  }
   RADIO_LoadCurrentVFO();
   APPS_exit();
   APPS_exit();
@@ -118,6 +197,8 @@ static void saveNamed() {
 }
 
 void CHLIST_init() {
+  rows = APPS_Claim(sizeof(Row) * ROWS_WINDOW);
+  rowsInvalidate();
   CHANNELS_LoadScanlist(gChListFilter, gSettings.currentScanlist);
   if (gChListFilter == TYPE_FILTER_BAND ||
       gChListFilter == TYPE_FILTER_BAND_SAVE) {
@@ -130,10 +211,31 @@ void CHLIST_init() {
   }
 }
 
-void CHLIST_deinit() { gChSaveMode = false; }
+void CHLIST_deinit() {
+  gChSaveMode = false;
+  Log("CHLIST rows hit=%u miss=%u", rowsHit, rowsMiss);
+}
+
+// one row per call, so reads never pile up in a single frame
+void CHLIST_update() {
+  const int16_t first = pageOffset();
+  const int16_t from = scrollDir > 0 ? first + ROWS_PAGE : first - ROWS_PAGE;
+
+  for (int16_t i = from; i < from + ROWS_PAGE; ++i) {
+    if (i < 0 || i >= gScanlistSize) {
+      continue;
+    }
+    Row row;
+    if (!rowGet(i, &row)) {
+      rowLoad(i, &row);
+      return;
+    }
+  }
+}
 
 bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
   uint16_t chNum = getChannelNumber(channelIndex);
+  const bool hasCh = chNum < SCANLIST_MAX; // list can be empty
   bool longHeld = state == KEY_LONG_PRESSED;
   bool simpleKeypress = state == KEY_RELEASED;
   if (!gIsNumNavInput && longHeld && key == KEY_STAR) {
@@ -155,7 +257,7 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
             gSettings.currentScanlist, key, longHeld && !simpleKeypress);
         SETTINGS_DelayedSave();
         CHLIST_init();
-      } else {
+      } else if (hasCh) {
         CHANNELS_Load(chNum, &ch);
         ch.scanlists = CHANNELS_ScanlistByKey(ch.scanlists, key, longHeld);
         CHANNELS_Save(chNum, &ch);
@@ -164,11 +266,11 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
     }
   }
 
-  if (viewMode == MODE_DELETE && simpleKeypress && key == KEY_1) {
+  if (viewMode == MODE_DELETE && simpleKeypress && key == KEY_1 && hasCh) {
     CHANNELS_Delete(chNum);
     return true;
   }
-  if (viewMode == MODE_TX && simpleKeypress && key == KEY_1) {
+  if (viewMode == MODE_TX && simpleKeypress && key == KEY_1 && hasCh) {
     CHANNELS_Load(chNum, &ch);
     ch.allowTx = !ch.allowTx;
     CHANNELS_Save(chNum, &ch);
@@ -193,6 +295,7 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
     case KEY_UP:
     case KEY_DOWN:
       channelIndex = IncDecU(channelIndex, 0, gScanlistSize, key != KEY_UP);
+      scrollDir = key == KEY_UP ? -1 : 1;
       return true;
     default:
       break;
@@ -239,15 +342,23 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
         }
         return true;
       }
-      RADIO_TuneToMR(chNum);
+      if (hasCh) {
+        RADIO_TuneToMR(chNum);
+      }
       APPS_exit();
       return true;
     case KEY_PTT:
+      if (!hasCh) {
+        return true;
+      }
       RADIO_TuneToMR(chNum);
       gVfo1ProMode = true;
       APPS_run(APP_VFO1);
       return true;
     case KEY_F:
+      if (!hasCh) {
+        return true;
+      }
       gChNum = chNum;
       CHANNELS_Load(gChNum, &gChEd);
       APPS_run(APP_CH_CFG);
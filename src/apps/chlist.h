@@ -8,6 +8,7 @@
 
 void CHLIST_init();
 void CHLIST_deinit();
+void CHLIST_update();
 bool CHLIST_key(KEY_Code_t key, Key_State_t state);
 void CHLIST_render();
 
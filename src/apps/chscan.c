@@ -5,41 +5,59 @@
 #include "../external/FreeRTOS/include/timers.h"
 #include "../external/FreeRTOS/portable/GCC/ARM_CM0/portmacro.h"
 #include "../helper/channels.h"
+#include "../helper/latency.h"
 #include "../helper/lootlist.h"
 #include "../radio.h"
+#include "../svc.h"
 #include "../ui/components.h"
 #include "../ui/graphics.h"
 
-void CHSCAN_init(void) {}
+static bool measuring;
 
-void CHSCAN_deinit(void) {}
+void CHSCAN_svcInit(void) { measuring = false; }
 
-void CHSCAN_update(void) {
+// next channel, then measure after 60ms; stays while squelch is open
+uint16_t CHSCAN_svcUpdate(void) {
+  if (gTxState == TX_ON) {
+    measuring = false;
+    return 100;
+  }
+  if (measuring) {
+    Measurement m = {
+        .f = radio->rxF,
+        .rssi = RADIO_GetRSSI(),
+        .snr = RADIO_GetSNR(),
+        .noise = BK4819_GetNoise(),
+        .glitch = BK4819_GetGlitch(),
+    };
+    m.timeUs = LAT_SinceTuneUs();
+    m.open = RADIO_IsSquelchOpen();
+    if (!gMonitorMode) {
+      LOOT_Update(&m);
+    }
+    RADIO_ToggleRX(m.open);
+    gRedrawScreen = true;
+  }
   if (!gIsListening) {
     CHANNELS_Next(true);
   }
-  vTaskDelay(pdMS_TO_TICKS(60));
-  Measurement m = {
-      .f = radio->rxF,
-      .rssi = RADIO_GetRSSI(),
-      .snr = RADIO_GetSNR(),
-      .noise = BK4819_GetNoise(),
-      .glitch = BK4819_GetGlitch(),
-  };
-  m.open = RADIO_IsSquelchOpen();
-  if (!gMonitorMode) {
-    LOOT_Update(&m);
-  }
-  RADIO_ToggleRX(m.open);
-  gRedrawScreen = true;
+  measuring = true;
+  return 60;
 }
 
+void CHSCAN_init(void) { SVC_Start(SVC_SCAN); }
+
+void CHSCAN_deinit(void) {}
+
 bool CHSCAN_key(KEY_Code_t Key, Key_State_t state) {
   if (state == KEY_RELEASED) {
     switch (Key) {
     case KEY_UP:
     case KEY_DOWN:
       return true;
+    case KEY_5:
+      SVC_Toggle(SVC_SCAN, !SVC_Running(SVC_SCAN));
+      return true;
     default:
       break;
     }
@@ -48,6 +66,13 @@ bool CHSCAN_key(KEY_Code_t Key, Key_State_t state) {
 }
 
 void CHSCAN_render(void) {
+  if (!SVC_Running(SVC_SCAN)) {
+    PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL, "Stopped");
+    PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "5: start");
+    return;
+  }
+  PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "CPU %u%%",
+               SVC_GetLoad(SVC_SCAN));
   if (gIsListening) {
     PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL, "MR %u", radio->channel + 1);
     PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "%u.%05u", radio->rxF / MHZ,
@@ -8,7 +8,9 @@
 bool CHSCAN_key(KEY_Code_t Key, Key_State_t state);
 void CHSCAN_init(void);
 void CHSCAN_deinit(void);
-void CHSCAN_update(void);
 void CHSCAN_render(void);
 
+void CHSCAN_svcInit(void);
+uint16_t CHSCAN_svcUpdate(void);
+
 #endif /* end of include guard: CHSCAN_H */
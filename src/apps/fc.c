@@ -1,9 +1,13 @@
 #include "fc.h"
 #include "../dcs.h"
-#include "../driver/system.h"
+#include "../driver/uart.h"
+#include "../helper/bands.h"
+#include "../helper/bandscan.h"
 #include "../radio.h"
 #include "../scheduler.h"
 #include "../settings.h"
+#include "../svc.h"
+#include "../system.h"
 #include "../ui/components.h"
 #include "../ui/graphics.h"
 #include "../ui/statusline.h"
@@ -25,10 +29,86 @@ static uint32_t fcTimeMs;
 
 static const uint32_t STEP = 100;
 
-static uint32_t lastSwitch = 0;
+#define FC_RING_SIZE 5
+#define FC_VOTES 2
+#define FC_CONFIRM_MS 200
 
 static bool scanning = false;
 
+// changes asked from keys, applied in service task
+typedef enum {
+  FC_REQ_NONE,
+  FC_REQ_RESET,
+  FC_REQ_BAND,
+  FC_REQ_SCAN_BAND,
+} FcRequest;
+
+static volatile FcRequest request;
+
+// recent counter results, voted instead of two-in-a-row agreement
+static uint32_t ring[FC_RING_SIZE];
+static uint8_t ringIndex;
+static uint8_t ringCount;
+static uint8_t missStreak;
+
+static bool confirming = false;
+static uint32_t confirmUntil;
+
+static uint32_t searchStart;
+static uint32_t lastLockMs;
+static uint32_t lockMsSum;
+static uint16_t lockCount;
+static uint16_t falseLockCount;
+
+static void ringClear() {
+  ringIndex = 0;
+  ringCount = 0;
+  missStreak = 0;
+}
+
+static void ringPush(uint32_t f) {
+  ring[ringIndex] = f;
+  ringIndex = (ringIndex + 1) % FC_RING_SIZE;
+  if (ringCount < FC_RING_SIZE) {
+    ringCount++;
+  }
+}
+
+// median of the biggest cluster within STEP, 0 if it has no quorum
+static uint32_t ringVote() {
+  uint8_t bestVotes = 0;
+  uint8_t best = 0;
+  for (uint8_t i = 0; i < ringCount; ++i) {
+    uint8_t votes = 0;
+    for (uint8_t j = 0; j < ringCount; ++j) {
+      if (DeltaF(ring[i], ring[j]) < STEP) {
+        votes++;
+      }
+    }
+    if (votes > bestVotes) {
+      bestVotes = votes;
+      best = i;
+    }
+  }
+
+  if (bestVotes < FC_VOTES) {
+    return 0;
+  }
+
+  uint32_t cluster[FC_RING_SIZE];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < ringCount; ++i) {
+    if (DeltaF(ring[best], ring[i]) < STEP) {
+      uint8_t k = n++;
+      for (; k > 0 && cluster[k - 1] > ring[i]; --k) {
+        cluster[k] = cluster[k - 1];
+      }
+      cluster[k] = ring[i];
+    }
+  }
+  return cluster[n / 2];
+}
+
 static void stopScan() {
   BK4819_StopScan();
   BK4819_RX_TurnOn();
@@ -39,89 +119,165 @@ static void gotF(uint32_t f) {
   scanning = false;
   RADIO_TuneTo(RoundToStep(f, STEP));
   RADIO_ToggleRX(true);
-  SYS_DelayMs(200);
+  if (bandAutoSwitch) {
+    BANDSCAN_Hit();
+  }
+
+  lastLockMs = Now() - searchStart;
+  lockMsSum += lastLockMs;
+  lockCount++;
+  Log("FC lock %u in %ums, T=%u", f, lastLockMs, T);
+
+  // faster counting while it locks fine
+  if (T > gSettings.fcTime) {
+    T--;
+  }
+
+  ringClear();
+  confirming = true;
+  confirmUntil = Now() + FC_CONFIRM_MS;
   gRedrawScreen = true;
 }
 
 static void switchBand() {
   scanF = 0;
   BK4819_SelectFilterEx(filter);
-  FC_init();
+  FC_svcInit();
+  if (bandAutoSwitch) {
+    BANDSCAN_Apply();
+  }
+}
+
+static void switchScanBand() {
+  filter = BANDSCAN_Current()->filter;
+  switchBand();
 }
 
 static void startScan() {
-  T = gSettings.fcTime;
   fcTimeMs = 200 << T;
   BK4819_StopScan();
   BK4819_EnableFrequencyScanEx(T);
   scanning = true;
 }
 
-void FC_init() {
+void FC_svcInit() {
   RADIO_LoadCurrentVFO();
   gMonitorMode = false;
 
+  T = gSettings.fcTime;
+  ringClear();
+  confirming = false;
+  searchStart = Now();
+
   // RADIO_ToggleRX(false);
   startScan();
   bound = SETTINGS_GetFilterBound();
 }
 
-void FC_deinit() { stopScan(); }
+void FC_svcDeinit() { stopScan(); }
+
+static void fcRequest(FcRequest r) {
+  request = r;
+  SVC_Start(SVC_FC);
+}
+
+void FC_init() { SVC_Start(SVC_FC); }
+
+void FC_deinit() {}
+
+uint16_t FC_svcUpdate() {
+  const FcRequest r = request;
+  request = FC_REQ_NONE;
+  switch (r) {
+  case FC_REQ_RESET:
+    FC_svcInit();
+    break;
+  case FC_REQ_BAND:
+    switchBand();
+    break;
+  case FC_REQ_SCAN_BAND:
+    switchScanBand();
+    break;
+  default:
+    break;
+  }
+
+  if (gTxState == TX_ON) {
+    return 100;
+  }
 
-void FC_update() {
   gRedrawScreen = true;
   if (gIsListening) {
-    vTaskDelay(pdMS_TO_TICKS(60));
+    if (confirming) {
+      // let squelch settle without blocking the service task
+      if (Now() < confirmUntil) {
+        return 10;
+      }
+      confirming = false;
+      if (!RADIO_IsSquelchOpen()) {
+        falseLockCount++;
+      }
+    }
     RADIO_CheckAndListen();
-    return;
+    if (!gIsListening) {
+      searchStart = Now();
+    }
+    return 60;
   }
 
-  if (bandAutoSwitch &&
-      (Now() - lastSwitch >= (uint32_t)(fcTimeMs * 2) + 200)) {
-    switch (filter) {
-    case FILTER_UHF:
-      filter = FILTER_VHF;
-      break;
-    case FILTER_VHF:
-    default:
-      filter = FILTER_UHF;
-      break;
-    }
-    switchBand();
-    lastSwitch = Now();
-    return;
+  if (bandAutoSwitch && BANDSCAN_Update()) {
+    switchScanBand();
+    return 1;
   }
 
   uint32_t f = 0;
   if (scanning && !BK4819_GetFrequencyScanResult(&f)) {
-    return;
+    return 1;
   }
 
   startScan();
 
   if (!f) {
-    return;
+    return 1;
   }
 
   if (f >= 8800000 && f < 10800000) {
-    return;
+    return 1;
   }
 
   if ((filter == FILTER_VHF && f >= bound) ||
       (filter == FILTER_UHF && f < bound)) {
-    return;
+    return 1;
+  }
+
+  if (bandAutoSwitch &&
+      (f < BANDSCAN_Current()->s || f > BANDSCAN_Current()->e)) {
+    return 1;
   }
 
   Loot *loot = LOOT_Get(f);
   if (loot && (loot->blacklist || loot->whitelist)) {
-    return;
+    return 1;
   }
 
-  if (DeltaF(f, scanF) < STEP) {
-    gotF(f);
-  }
   scanF = f;
-  vTaskDelay(pdMS_TO_TICKS(200));
+  ringPush(f);
+
+  uint32_t votedF = ringVote();
+  if (votedF) {
+    gotF(votedF);
+    return 1;
+  }
+
+  // noisy counts: longer gate time gives steadier results
+  if (++missStreak >= FC_RING_SIZE * 2) {
+    missStreak = 0;
+    if (T < F_SC_T_1_6s) {
+      T++;
+      ringClear();
+    }
+  }
+  return 1;
 }
 
 bool FC_key(KEY_Code_t key, Key_State_t state) {
@@ -131,7 +287,7 @@ bool FC_key(KEY_Code_t key, Key_State_t state) {
     case KEY_DOWN:
       gSettings.fcTime = IncDecI(gSettings.fcTime, 0, 3 + 1, key == KEY_UP);
       SETTINGS_DelayedSave();
-      FC_init();
+      fcRequest(FC_REQ_RESET);
       break;
     case KEY_3:
     case KEY_9:
@@ -143,12 +299,28 @@ bool FC_key(KEY_Code_t key, Key_State_t state) {
       return true;
     case KEY_F:
       filter = IncDecU(filter, 0, 3, true);
-      switchBand();
+      fcRequest(FC_REQ_BAND);
       return true;
     case KEY_0:
-      bandAutoSwitch = !bandAutoSwitch;
+      if (bandAutoSwitch) {
+        bandAutoSwitch = false;
+        fcRequest(FC_REQ_RESET);
+        return true;
+      }
+      SVC_Stop(SVC_FC); // band list is read by service
+      if (!BANDSCAN_Load()) {
+        SYS_MsgNotify("No bands in SL", 1000);
+        SVC_Start(SVC_FC);
+        return true;
+      }
+      bandAutoSwitch = true;
+      fcRequest(FC_REQ_SCAN_BAND);
+      return true;
+    case KEY_5:
+      SVC_Toggle(SVC_FC, !SVC_Running(SVC_FC));
       return true;
     case KEY_PTT:
+      SVC_Stop(SVC_FC);
       gVfo1ProMode = true;
       APPS_run(APP_VFO1);
       return true;
@@ -160,20 +332,43 @@ bool FC_key(KEY_Code_t key, Key_State_t state) {
 }
 
 void FC_render() {
-  PrintMediumEx(0, 16, POS_L, C_FILL, "%s %ums SQ %u %s", FILTER_NAMES[filter],
+  if (!SVC_Running(SVC_FC)) {
+    PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL, "Stopped");
+    PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "5: start");
+    return;
+  }
+  PrintSmallEx(0, LCD_HEIGHT - 2, POS_L, C_FILL, "CPU %u%%",
+               SVC_GetLoad(SVC_FC));
+
+  PrintMediumEx(0, 16, POS_L, C_FILL, "%s %ums SQ %u %s",
+                bandAutoSwitch ? gCurrentBand.name : FILTER_NAMES[filter],
                 fcTimeMs, radio->squelch.value, bandAutoSwitch ? "[A]" : "");
+
+  if (bandAutoSwitch) {
+    const ScanBand *sb = BANDSCAN_Current();
+    const uint32_t total = BANDSCAN_TotalDwell();
+    PrintSmallEx(0, 22, POS_L, C_FILL, "%u.%05u-%u.%05u", sb->s / MHZ,
+                 sb->s % MHZ, sb->e / MHZ, sb->e % MHZ);
+    PrintSmallEx(LCD_WIDTH, 22, POS_R, C_FILL, "%u%% A%u",
+                 total ? sb->dwellMs / ((total + 99) / 100) : 0, sb->activity);
+  }
   UI_BigFrequency(40, scanF);
 
+  PrintSmallEx(0, 28, POS_L, C_FILL, "L%u F%u", lockCount, falseLockCount);
+  PrintSmallEx(LCD_WIDTH, 28, POS_R, C_FILL, "%ums avg %ums", lastLockMs,
+               lockCount ? lockMsSum / lockCount : 0);
+
   if (gLastActiveLoot) {
     PrintMediumEx(LCD_WIDTH, 40 + 8, POS_R, C_FILL, "%u.%05u",
                   gLastActiveLoot->f / MHZ, gLastActiveLoot->f % MHZ);
-    if (gLastActiveLoot->ct != 0xFF) {
+    const uint8_t ct = LOOT_GetCt(gLastActiveLoot);
+    const uint8_t cd = LOOT_GetCd(gLastActiveLoot);
+    if (ct != LOOT_TONE_NONE) {
       PrintSmallEx(LCD_WIDTH, 40 + 8 + 6, POS_R, C_FILL, "CT:%u.%uHz",
-                   CTCSS_Options[gLastActiveLoot->ct] / 10,
-                   CTCSS_Options[gLastActiveLoot->ct] % 10);
-    } else if (gLastActiveLoot->cd != 0xFF) {
+                   CTCSS_Options[ct] / 10, CTCSS_Options[ct] % 10);
+    } else if (cd != LOOT_TONE_NONE) {
       PrintSmallEx(LCD_WIDTH, 40 + 8 + 6, POS_R, C_FILL, "DCS:D%03oN",
-                   DCS_Options[gLastActiveLoot->cd]);
+                   DCS_Options[cd]);
     }
   }
 }
@@ -7,8 +7,11 @@
 
 void FC_init();
 void FC_deinit();
-void FC_update();
 bool FC_key(KEY_Code_t key, Key_State_t state);
 void FC_render();
 
+void FC_svcInit();
+uint16_t FC_svcUpdate();
+void FC_svcDeinit();
+
 #endif /* end of include guard: FC_APP_H */
@@ -1,5 +1,5 @@
 #include "generator.h"
-#include "../driver/bk4819.h"
+#include "../helper/toneseq.h"
 #include "../misc.h"
 #include "../radio.h"
 #include "../ui/graphics.h"
@@ -36,11 +36,12 @@ static void updatePower(int8_t v) {
 void GENERATOR_init() { calcPower(); }
 void GENERATOR_update() {}
 bool GENERATOR_key(KEY_Code_t key, Key_State_t state) {
-  const uint16_t M[] = {tone1Freq, 0, 0, 0};
+  static uint16_t M[] = {0, 0, 0, 0};
   if (key == KEY_PTT) {
     RADIO_ToggleTXEX(state == KEY_PRESSED, RADIO_GetTXF(), power, bkPower);
     if (state == KEY_PRESSED && gTxState == TX_ON) {
-      BK4819_PlaySequence(M);
+      M[0] = tone1Freq;
+      TONESEQ_Play(M, NULL);
     }
 
     return true;
@@ -0,0 +1,79 @@
+#include "latview.h"
+#include "../driver/st7565.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include "../helper/latency.h"
+#include "../helper/measurements.h"
+#include "../ui/graphics.h"
+#include "apps.h"
+
+#define BAR_W 10
+#define BAR_X ((LCD_WIDTH - LAT_BUCKETS * BAR_W) / 2)
+#define BAR_Y 18
+#define BAR_H 30
+
+static uint8_t span;
+
+static void printUs(uint8_t x, uint8_t y, TextPos pos, const char *prefix,
+                    uint32_t us) {
+  if (us >= 10000) {
+    PrintSmallEx(x, y, pos, C_FILL, "%s%ums", prefix, us / 1000);
+  } else {
+    PrintSmallEx(x, y, pos, C_FILL, "%s%uus", prefix, us);
+  }
+}
+
+void LATVIEW_update(void) {
+  gRedrawScreen = true;
+  vTaskDelay(pdMS_TO_TICKS(500));
+}
+
+bool LATVIEW_key(KEY_Code_t Key, Key_State_t state) {
+  if (state != KEY_RELEASED) {
+    return false;
+  }
+  switch (Key) {
+  case KEY_UP:
+  case KEY_DOWN:
+    span = IncDecU(span, 0, LAT_COUNT, Key != KEY_UP);
+    gRedrawScreen = true;
+    return true;
+  case KEY_0:
+    LAT_Reset();
+    gRedrawScreen = true;
+    return true;
+  case KEY_EXIT:
+    APPS_exit();
+    return true;
+  default:
+    return false;
+  }
+}
+
+void LATVIEW_render(void) {
+  const LatHist *h = LAT_Get(span);
+
+  PrintMediumEx(0, 14, POS_L, C_FILL, "%s", LAT_NAMES[span]);
+  PrintSmallEx(LCD_WIDTH, 14, POS_R, C_FILL, "n=%u", h->count);
+
+  uint16_t top = 1;
+  for (uint8_t i = 0; i < LAT_BUCKETS; ++i) {
+    if (h->hist[i] > top) {
+      top = h->hist[i];
+    }
+  }
+  for (uint8_t i = 0; i < LAT_BUCKETS; ++i) {
+    const uint8_t x = BAR_X + i * BAR_W;
+    const uint8_t bh = h->hist[i] ? 1 + (h->hist[i] * (BAR_H - 1)) / top : 0;
+    FillRect(x + 1, BAR_Y + BAR_H - bh, BAR_W - 2, bh, C_FILL);
+  }
+  DrawHLine(BAR_X, BAR_Y + BAR_H, LAT_BUCKETS * BAR_W, C_FILL);
+
+  // some bucket edges, us
+  printUs(BAR_X + BAR_W, BAR_Y + BAR_H + 6, POS_C, "", LAT_EDGES_US[0]);
+  printUs(BAR_X + 5 * BAR_W, BAR_Y + BAR_H + 6, POS_C, "", LAT_EDGES_US[4]);
+  printUs(BAR_X + 11 * BAR_W, BAR_Y + BAR_H + 6, POS_C, "", LAT_EDGES_US[10]);
+
+  printUs(0, LCD_HEIGHT - 2, POS_L, "max ", h->maxUs);
+  PrintSmallEx(LCD_WIDTH, LCD_HEIGHT - 2, POS_R, C_FILL, "0: reset");
+}
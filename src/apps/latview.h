@@ -0,0 +1,12 @@
+#ifndef LATVIEW_H
+#define LATVIEW_H
+
+#include "../driver/keyboard.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+bool LATVIEW_key(KEY_Code_t Key, Key_State_t state);
+void LATVIEW_update(void);
+void LATVIEW_render(void);
+
+#endif /* end of include guard: LATVIEW_H */
@@ -8,6 +8,7 @@
 #include "../helper/measurements.h"
 #include "../radio.h"
 #include "../scheduler.h"
+#include "../svc.h"
 #include "../system.h"
 #include "../ui/components.h"
 #include "../ui/graphics.h"
@@ -48,7 +49,11 @@ static Sort sortType = SORT_LOT;
 static bool shortList = true;
 static bool sortRev = false;
 
+// browsing a sweep doesn't retune, taking item over stops the scan service
 static void tuneToLoot(const Loot *loot, bool save) {
+  if (!save && SVC_RadioBusy()) {
+    return;
+  }
   if (save) {
     RADIO_TuneToSave(loot->f);
   } else {
@@ -72,16 +77,18 @@ static void getLootItem(uint16_t i, uint16_t index, bool isCurrent) {
   displayFreqBlWl(y, item);
 
   PrintSmallEx(LCD_WIDTH - 6, y + 7, POS_R, C_INVERT, "%us",
-               item->duration / 1000);
+               LOOT_DurationMs(item) / 1000);
 
   // PrintSmallEx(8, y + 7 + 6, POS_L, C_INVERT, "%03ddB",
   // Rssi2DBm(item->rssi));
-  if (item->ct != 0xFF) {
+  const uint8_t ct = LOOT_GetCt(item);
+  const uint8_t cd = LOOT_GetCd(item);
+  if (ct != LOOT_TONE_NONE) {
     PrintSmallEx(8 + 55, y + 7 + 6, POS_L, C_INVERT, "CT:%u.%uHz",
-                 CTCSS_Options[item->ct] / 10, CTCSS_Options[item->ct] % 10);
-  } else if (item->cd != 0xFF) {
+                 CTCSS_Options[ct] / 10, CTCSS_Options[ct] % 10);
+  } else if (cd != LOOT_TONE_NONE) {
     PrintSmallEx(8 + 55, y + 7 + 6, POS_L, C_INVERT, "DCS:D%03oN",
-                 DCS_Options[item->cd]);
+                 DCS_Options[cd]);
   }
 }
 
@@ -89,7 +96,7 @@ static void getLootItemShort(uint16_t i, uint16_t index, bool isCurrent) {
   const Loot *loot = LOOT_Item(index);
   const uint8_t x = LCD_WIDTH - 6;
   const uint8_t y = MENU_Y + i * MENU_ITEM_H;
-  const uint32_t ago = (Now() - loot->lastTimeOpen) / 1000;
+  const uint32_t ago = LOOT_AgoS(loot);
 
   if (isCurrent) {
     FillRect(0, y, LCD_WIDTH - 3, MENU_ITEM_H, C_FILL);
@@ -103,7 +110,7 @@ static void getLootItemShort(uint16_t i, uint16_t index, bool isCurrent) {
   case SORT_DUR:
   case SORT_BL:
   case SORT_F:
-    PrintSmallEx(x, y + 7, POS_R, C_INVERT, "%us", loot->duration / 1000);
+    PrintSmallEx(x, y + 7, POS_R, C_INVERT, "%us", LOOT_DurationMs(loot) / 1000);
     break;
   }
 }
@@ -187,7 +194,9 @@ bool LOOTLIST_key(KEY_Code_t key, Key_State_t state) {
     switch (key) {
     case KEY_0:
       LOOT_Clear();
-      RADIO_TuneToPure(0, true);
+      if (!SVC_RadioBusy()) {
+        RADIO_TuneToPure(0, true);
+      }
       return true;
     case KEY_SIDE1:
       gMonitorMode = !gMonitorMode;
@@ -245,10 +254,12 @@ bool LOOTLIST_key(KEY_Code_t key, Key_State_t state) {
     case KEY_SIDE1:
       loot->whitelist = false;
       loot->blacklist = !loot->blacklist;
+      loot->dirty = true;
       return true;
     case KEY_SIDE2:
       loot->blacklist = false;
       loot->whitelist = !loot->whitelist;
+      loot->dirty = true;
       return true;
     case KEY_7:
       shortList = !shortList;
@@ -268,9 +279,9 @@ bool LOOTLIST_key(KEY_Code_t key, Key_State_t state) {
         menuIndex = LOOT_Size() - 1;
       }
       loot = LOOT_Item(menuIndex);
-      if (loot) {
+      if (LOOT_Size()) {
         tuneToLoot(loot, false);
-      } else {
+      } else if (!SVC_RadioBusy()) {
         RADIO_TuneToPure(0, true);
       }
       return true;
@@ -1,8 +1,8 @@
 #include "morse.h"
-#include "../driver/bk4819.h"
 #include "../driver/uart.h"
 #include "../external/FreeRTOS/include/task.h"
 #include "../helper/measurements.h"
+#include "../helper/toneseq.h"
 #include "../radio.h"
 #include "../ui/graphics.h"
 #include "../ui/statusline.h"
@@ -62,19 +62,17 @@ static const uint16_t TONE_FREQ = 700;   // Hz
 
 typedef enum {
   STATE_IDLE,
-  STATE_STARTING,
-  STATE_NEXT_CHAR,
-  STATE_NEXT_SYMBOL,
-  STATE_TX_TONE,
-  STATE_TX_GAP,
-  STATE_STOPPING,
+  STATE_SENDING,
 } MorseState;
 
-static char inputText[32];
+#define TEXT_SIZE 32
+
+static char *inputText; // app state
 static uint8_t textPos;
 static uint8_t morsePos;
-static MorseState morseState = STATE_IDLE;
-static uint32_t stateTimer;
+static volatile MorseState morseState = STATE_IDLE;
+static bool leadSent;
+static bool symbolSent;
 
 // --- Helper Functions ---
 
@@ -107,97 +105,81 @@ static void textInputCallback(void) { morseState = STATE_IDLE; }
 
 static void launchTextInput(void) {
   gTextinputText = inputText;
-  gTextInputSize = sizeof(inputText) - 1;
+  gTextInputSize = TEXT_SIZE - 1;
   gTextInputCallback = textInputCallback;
   APPS_run(APP_TEXTINPUT);
 }
 
 void MORSE_init(void) {
-  memset(inputText, 0, sizeof(inputText));
+  inputText = APPS_Claim(TEXT_SIZE);
   launchTextInput();
 }
 
-void MORSE_deinit(void) {
-  if (gTxState == TX_ON) {
-    RADIO_ToggleTX(false);
-  }
-}
-
-void MORSE_update(void) {
-  if (morseState == STATE_IDLE) {
-    vTaskDelay(pdMS_TO_TICKS(100));
-    return;
+// Keying runs in tone sequencer: 1 s of muted carrier for squelch to open,
+// then each symbol (or word gap) followed by one dot of silence.
+static bool morseNext(ToneStep *step) {
+  step->note = 0;
+  if (!leadSent) {
+    leadSent = true;
+    step->ms = 1000;
+    return true;
   }
-
-  if (Now() < stateTimer) {
-    return;
+  if (symbolSent) {
+    symbolSent = false;
+    step->ms = dotDuration;
+    return true;
   }
 
-  switch (morseState) {
-  case STATE_STARTING:
-    RADIO_ToggleTX(true);
-    if (gTxState == TX_ON) {
-      // Set up the tone generator, but keep it muted
-      BK4819_TransmitTone(TONE_FREQ);
-      BK4819_EnterTxMute();
-
-      // Set the timer for the 1-second squelch delay
-      stateTimer = Now() + 1000;
-
-      // Set the next state to begin sending the actual symbols
-      morseState = STATE_NEXT_CHAR;
-    }
-    break;
-
-  case STATE_NEXT_CHAR:
-    if (textPos >= strlen(inputText)) {
-      morseState = STATE_STOPPING;
-      break;
-    }
+  const size_t len = strlen(inputText);
+  while (textPos < len && !getMorseString(inputText[textPos])[morsePos]) {
+    textPos++;
     morsePos = 0;
-    morseState = STATE_NEXT_SYMBOL;
-    break;
+  }
+  if (textPos >= len) {
+    return false;
+  }
 
-  case STATE_NEXT_SYMBOL: {
-    const char *morseStr = getMorseString(inputText[textPos]);
-    char symbol = morseStr[morsePos];
+  const char symbol = getMorseString(inputText[textPos])[morsePos++];
+  if (symbol == ' ') { // Word gap
+    step->ms = dotDuration * 7;
+  } else { // Dot or Dash
+    step->note = TONE_FREQ;
+    step->ms = symbol == '.' ? dotDuration : dotDuration * 3;
+  }
+  symbolSent = true;
+  return true;
+}
 
-    if (symbol == '\0') { // End of character
-      textPos++;
-      morseState = STATE_NEXT_CHAR;
-      break;
-    }
+static void morseDone(void) {
+  morseState = STATE_IDLE;
+  RADIO_ToggleTX(false);
+}
 
-    if (symbol == ' ') { // Word gap
-      BK4819_EnterTxMute();
-      stateTimer = Now() + (dotDuration * 7);
-    } else { // Dot or Dash
-      BK4819_ExitTxMute();
-      uint16_t duration = (symbol == '.') ? dotDuration : (dotDuration * 3);
-      stateTimer = Now() + duration;
-    }
-    morseState = STATE_TX_GAP;
-    break;
+static void morseStart(void) {
+  RADIO_ToggleTX(true);
+  if (gTxState != TX_ON) {
+    return;
   }
+  textPos = 0;
+  morsePos = 0;
+  leadSent = false;
+  symbolSent = false;
+  morseState = STATE_SENDING;
+  TONESEQ_Run(morseNext, morseDone);
+}
 
-  case STATE_TX_GAP:
-    BK4819_EnterTxMute();
-    morsePos++;
-    morseState = STATE_NEXT_SYMBOL;
-    stateTimer = Now() + dotDuration; // Inter-symbol gap
-    break;
-
-  case STATE_STOPPING:
+static void morseStop(void) {
+  TONESEQ_Stop();
+  morseState = STATE_IDLE;
+  if (gTxState == TX_ON) {
     RADIO_ToggleTX(false);
-    morseState = STATE_IDLE;
-    break;
-
-  default:
-    morseState = STATE_IDLE;
-    break;
   }
 }
 
+void MORSE_deinit(void) { morseStop(); }
+
+void MORSE_update(void) { vTaskDelay(pdMS_TO_TICKS(100)); }
+
 void MORSE_render() {
   char status[32];
   switch (morseState) {
@@ -226,14 +208,10 @@ bool MORSE_key(KEY_Code_t key, Key_State_t state) {
   switch (key) {
   case KEY_PTT:
     if (morseState == STATE_IDLE) {
-      // Reset state for new transmission
-      textPos = 0;
-      morsePos = 0;
-      morseState = STATE_STARTING;
+      morseStart();
     } else {
-      morseState = STATE_STOPPING;
+      morseStop();
     }
-    MORSE_update(); // Run update once to start/stop immediately
     return true;
 
   case KEY_1:
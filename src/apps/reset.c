@@ -5,6 +5,7 @@
 #include "../external/CMSIS_5/Device/ARM/ARMCM0/Include/ARMCM0.h"
 #include "../helper/channels.h"
 #include "../helper/measurements.h"
+#include "../helper/nvring.h"
 #include "../radio.h"
 #include "../scheduler.h"
 #include "../settings.h"
@@ -228,6 +229,9 @@ static bool unreborn(void) {
 }
 
 void RESET_Init(void) {
+  // keep partial resets consistent, then write home locations directly
+  NVRING_Sync();
+  NVRING_Disable();
   resetType = RESET_UNKNOWN;
   gSettings.eepromType = EEPROM_UNKNOWN;
   gSettings.keylock = false;
@@ -258,6 +262,10 @@ void RESET_Update(void) {
     return;
   }
 
+  // ring may hold records from before reset, void them
+  NVRING_Init();
+  NVRING_Discard();
+
   NVIC_SystemReset();
 }
 
@@ -2,10 +2,14 @@
 #include "../driver/st7565.h"
 #include "../driver/uart.h"
 #include "../helper/bands.h"
+#include "../helper/bandscan.h"
+#include "../helper/latency.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
 #include "../radio.h"
 #include "../scheduler.h"
+#include "../svc.h"
+#include "../system.h"
 #include "../ui/components.h"
 #include "../ui/spectrum.h"
 #include "../ui/statusline.h"
@@ -32,6 +36,25 @@ static uint16_t msmHigh;
 static uint32_t cursorRangeTimeout = 0;
 
 static bool isAnalyserMode = false;
+static bool multiBand = false;
+
+// coarse-to-fine sweep: one wide-filter point per column finds energy, then
+// only active columns are walked at the band step
+#define COARSE_BINS 128
+#define COARSE_MARGIN 8
+
+typedef enum {
+  SWEEP_FULL,
+  SWEEP_COARSE,
+  SWEEP_FINE,
+} SweepPhase;
+
+static SweepPhase sweepPhase = SWEEP_FULL;
+static uint8_t coarseX;
+static uint8_t activeBins[COARSE_BINS / 8];
+static uint16_t coarseFloor;
+static uint16_t coarseFloorNext;
+static uint32_t fineEndF;
 
 typedef enum {
   SET_AGC,
@@ -51,12 +74,75 @@ static uint16_t measure(uint32_t f) {
   return RADIO_GetRSSI();
 }
 
+static bool isBinActive(uint8_t x) {
+  return activeBins[x >> 3] & (1 << (x & 7));
+}
+
+static void startCoarse() {
+  // fine pass may end on open squelch, coarse points never close it
+  if (m->open || gIsListening) {
+    m->open = false;
+    LOOT_Update(m);
+    RADIO_ToggleRX(false);
+  }
+  sweepPhase = SWEEP_COARSE;
+  coarseX = 0;
+  coarseFloorNext = UINT16_MAX;
+  for (uint8_t i = 0; i < ARRAY_SIZE(activeBins); ++i) {
+    activeBins[i] = 0;
+  }
+  RADIO_SetFilterBandwidth(BK4819_FILTER_BW_26k);
+  radio->rxF = SP_X2F(0);
+}
+
+// returns false when no active column is left
+static bool nextFineBin(uint8_t fromX) {
+  const uint32_t step = StepFrequencyTable[radio->step];
+  for (uint8_t x = fromX; x < COARSE_BINS; ++x) {
+    if (isBinActive(x)) {
+      coarseX = x;
+      radio->rxF = RoundToStep(SP_X2F(x), step);
+      if (radio->rxF < b->rxF) {
+        radio->rxF = b->rxF;
+      }
+      // exclusive, last column includes band end as full sweep does
+      fineEndF = x < COARSE_BINS - 1 ? SP_X2F(x + 1) : b->txF + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
 static void onNewBand() {
   gCurrentBand = *b;
   radio->rxF = b->rxF;
   RADIO_Setup();
   SP_Init(b);
   isAnalyserMode = BANDS_RangeIndex() == RANGES_STACK_SIZE - 1;
+  coarseFloor = 0;
+  if (sweepPhase != SWEEP_FULL) {
+    startCoarse();
+  }
+}
+
+static void switchScanBand() {
+  BANDSCAN_Apply();
+  gCurrentBand.meta.type = TYPE_BAND_DETACHED;
+  BANDS_RangeClear();
+  BANDS_RangePush(gCurrentBand);
+  b = BANDS_RangePeek();
+  CUR_Reset();
+  onNewBand();
+}
+
+// called at the end of each full sweep
+static bool sweepDone() {
+  SP_Stream();
+  if (multiBand && BANDSCAN_Update()) {
+    switchScanBand();
+    return true;
+  }
+  return false;
 }
 
 static void setStartF(uint32_t f) {
@@ -99,6 +185,8 @@ static void changeSetting(bool up) {
 }
 
 void SCANER_init(void) {
+  SVC_StopRadio();
+  SP_Claim();
   SPECTRUM_Y = 8;
   SPECTRUM_H = 44;
 
@@ -125,12 +213,43 @@ void SCANER_init(void) {
   onNewBand();
 }
 
+static void nextCoarse() {
+  if (++coarseX < COARSE_BINS) {
+    radio->rxF = SP_X2F(coarseX);
+    return;
+  }
+
+  coarseFloor = coarseFloorNext;
+  gRedrawScreen = true;
+  RADIO_SetFilterBandwidth(radio->bw);
+  sweepPhase = SWEEP_FINE;
+  if (!nextFineBin(0) && !sweepDone()) {
+    startCoarse();
+  }
+}
+
 static void next() {
+  if (sweepPhase == SWEEP_COARSE) {
+    nextCoarse();
+    return;
+  }
+
   radio->rxF += StepFrequencyTable[radio->step];
 
+  if (sweepPhase == SWEEP_FINE) {
+    if (radio->rxF >= fineEndF && !nextFineBin(coarseX + 1)) {
+      gRedrawScreen = true;
+      if (!sweepDone()) {
+        startCoarse();
+      }
+    }
+    return;
+  }
+
   if (radio->rxF > b->txF) {
     radio->rxF = b->rxF;
     gRedrawScreen = true;
+    sweepDone();
   }
 }
 
@@ -155,12 +274,37 @@ static void nextWithTimeout() {
   }
 }
 
+static void updateCoarse() {
+  m->f = radio->rxF;
+  m->rssi = measure(radio->rxF);
+  m->timeUs = LAT_SinceTuneUs();
+  m->open = false;
+
+  SP_AddPoint(m);
+
+  if (m->rssi < coarseFloorNext) {
+    coarseFloorNext = m->rssi;
+  }
+  // first pass has no floor yet, so everything gets refined once
+  if (!coarseFloor || m->rssi >= coarseFloor + COARSE_MARGIN) {
+    activeBins[coarseX >> 3] |= 1 << (coarseX & 7);
+  }
+
+  next();
+}
+
 void SCANER_update(void) {
+  if (sweepPhase == SWEEP_COARSE) {
+    updateCoarse();
+    return;
+  }
+
   if (m->open) {
     m->open = RADIO_IsSquelchOpen();
   } else {
     m->f = radio->rxF;
     m->rssi = measure(radio->rxF);
+    m->timeUs = LAT_SinceTuneUs();
 
     if (!sqLevel && m->rssi) {
       sqLevel = m->rssi - 1;
@@ -193,6 +337,8 @@ void SCANER_update(void) {
     gRedrawScreen = true;
     if (!m->open) {
       sqLevel++;
+    } else if (multiBand) {
+      BANDSCAN_Hit();
     }
   }
 
@@ -233,6 +379,16 @@ bool SCANER_key(KEY_Code_t key, Key_State_t state) {
       gChListFilter = TYPE_FILTER_BAND;
       APPS_run(APP_CH_LIST);
       return true;
+    case KEY_6:
+      if (multiBand) {
+        multiBand = false;
+      } else if (BANDSCAN_Load()) {
+        multiBand = true;
+        switchScanBand();
+      } else {
+        SYS_MsgNotify("No bands in SL", 1000);
+      }
+      return true;
     default:
       break;
     }
@@ -286,6 +442,17 @@ bool SCANER_key(KEY_Code_t key, Key_State_t state) {
     case KEY_STAR:
       APPS_run(APP_LOOT_LIST);
       return true;
+    case KEY_6:
+      if (sweepPhase == SWEEP_FULL) {
+        startCoarse();
+      } else {
+        sweepPhase = SWEEP_FULL;
+        RADIO_SetFilterBandwidth(radio->bw);
+        radio->rxF = b->rxF;
+      }
+      SP_ResetHistory();
+      SP_Begin();
+      return true;
 
     case KEY_0:
       BANDS_RangePush(
@@ -358,6 +525,16 @@ void SCANER_render(void) {
                  BANDS_RangeIndex() + 1);
   }
 
+  if (sweepPhase != SWEEP_FULL) {
+    PrintSmallEx(LCD_WIDTH, 24, POS_R, C_FILL,
+                 sweepPhase == SWEEP_COARSE ? "C2F c" : "C2F f");
+  }
+
+  if (multiBand) {
+    PrintSmallEx(LCD_WIDTH, 30, POS_R, C_FILL, "%s A%u", gCurrentBand.name,
+                 BANDSCAN_Current()->activity);
+  }
+
   if (isAnalyserMode) {
     renderAnalyzerUI();
   }
@@ -379,4 +556,8 @@ void SCANER_render(void) {
   }
 }
 
-void SCANER_deinit(void) {}
+void SCANER_deinit(void) {
+  if (sweepPhase == SWEEP_COARSE) {
+    RADIO_SetFilterBandwidth(radio->bw);
+  }
+}
@@ -11,8 +11,11 @@
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
 #include "../helper/numnav.h"
+#include "../helper/rds.h"
+#include "../helper/toneseq.h"
 #include "../radio.h"
 #include "../scheduler.h"
+#include "../svc.h"
 #include "../ui/components.h"
 #include "../ui/graphics.h"
 #include "../ui/spectrum.h"
@@ -21,6 +24,7 @@
 #include "chcfg.h"
 #include "chlist.h"
 #include "finput.h"
+#include <string.h>
 
 #define BATTERY_SAVE_COUNTDOWN (100)
 #define BATTERY_SAVE_60MS (8)
@@ -120,12 +124,13 @@ static void tuneTo(uint32_t f) {
 }
 
 static char message[16] = {'\0'};
+static void dtmfDone(void) { RADIO_ToggleTX(false); }
+
 static void sendDtmf() {
   RADIO_ToggleTX(true);
   if (gTxState == TX_ON) {
     BK4819_EnterDTMF_TX(true);
-    BK4819_PlayDTMFString(message, true, 100, 100, 100, 100);
-    RADIO_ToggleTX(false);
+    TONESEQ_PlayDTMF(message, 0, 100, 100, dtmfDone);
   }
 }
 
@@ -137,6 +142,12 @@ void VFO1_init(void) {
 }
 
 void VFO1_update(void) {
+	if (SVC_RadioBusy()) { // service tunes and listens
+		gRedrawScreen = true;
+		vTaskDelay(pdMS_TO_TICKS(60));
+		return;
+	}
+
 	if (BATTERY_SAVE_60MS > 0 && gTxState != TX_ON) {
 		if (gPowerSave_60ms > 0) {
 			RADIO_CheckAndListen();
@@ -480,6 +491,37 @@ static void renderProModeInfo(uint8_t y, const VFO *radio) {
   DrawRegs();
 }
 
+#define RT_VISIBLE 24
+
+// decoded by RDS service, nothing is read from chip here
+static void renderRds(void) {
+  if (!gRDS.pi) {
+    return;
+  }
+  const uint8_t y = LCD_HEIGHT - 7;
+  PrintSmall(0, y, "%04X", gRDS.pi);
+  if (RDS_PsReady()) {
+    PrintMediumEx(LCD_XCENTER, y, POS_C, C_FILL, "%s", gRDS.ps);
+  }
+  if (gRDSStats.received) {
+    PrintSmallEx(LCD_WIDTH, y, POS_R, C_FILL, "%u%%",
+                 gRDSStats.decoded * 100 / gRDSStats.received);
+  }
+
+  uint8_t len = strlen(gRDS.rt);
+  while (len && gRDS.rt[len - 1] == ' ') {
+    len--;
+  }
+  const uint8_t from =
+      len > RT_VISIBLE ? Now() / 500 % (len - RT_VISIBLE + 1) : 0;
+  PrintSmall(0, LCD_HEIGHT - 1, "%.*s", len < RT_VISIBLE ? len : RT_VISIBLE,
+             gRDS.rt + from);
+  if (gRDS.ct) {
+    PrintSmallEx(LCD_WIDTH, LCD_HEIGHT - 1, POS_R, C_FILL, "%02u:%02u",
+                 gRDS.hour, gRDS.minute);
+  }
+}
+
 void VFO1_render(void) {
   const uint8_t BASE = 40;
 
@@ -502,6 +544,8 @@ void VFO1_render(void) {
 
   if (gVfo1ProMode) {
     renderProModeInfo(BASE, radio);
+  } else if (RADIO_GetRadio() == RADIO_SI4732) {
+    renderRds();
   }
 }
 
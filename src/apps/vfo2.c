@@ -2,6 +2,7 @@
 #include "../dcs.h"
 #include "../helper/bands.h"
 #include "../helper/lootlist.h"
+#include "../helper/rds.h"
 #include "../misc.h"
 #include "../scheduler.h"
 #include "../settings.h"
@@ -55,7 +56,9 @@ static void renderAdditionalInfo(uint8_t bl, const VFO *vfo,
                                  const Measurement *msm) {
   char str[64];
 
-  if (vfo->radio == RADIO_BK4819) {
+  if (vfo->radio == RADIO_SI4732 && vfo == radio && RDS_PsReady()) {
+    PrintSmallEx(0, bl + 6, POS_L, C_FILL, "%s", gRDS.ps);
+  } else if (vfo->radio == RADIO_BK4819) {
     if (msm->ct != 0xFF) {
       PrintSmallEx(0, bl + 6, POS_L, C_FILL, "C%u.%u",
                    CTCSS_Options[msm->ct] / 10, CTCSS_Options[msm->ct] % 10);
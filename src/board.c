@@ -3,7 +3,6 @@
 #include "driver/backlight.h"
 #include "driver/crc.h"
 #include "driver/gpio.h"
-#include "driver/st7565.h"
 #include "driver/uart.h"
 #include "inc/dp32g030/gpio.h"
 #include "inc/dp32g030/portcon.h"
@@ -409,9 +408,8 @@ void BOARD_ToggleRed(bool on) {
   BK4819_ToggleGpioOut(BK4819_GPIO5_PIN1_RED, on);
 }
 
+// display is brought up as separate boot stage, see SYS_Main
 void BOARD_Init(void) {
-  Log("INIT DISPLAY");
-  ST7565_Init(true);
   Log("INIT BL");
   BACKLIGHT_Init();
   Log("INIT KBD");
@@ -40,11 +40,12 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend 0
 #define INCLUDE_vTaskDelayUntil 1
 #define INCLUDE_vTaskDelay 1
-#define INCLUDE_xTaskGetSchedulerState 0
+#define INCLUDE_xTaskGetSchedulerState 1
 #define INCLUDE_xTimerPendFunctionCall 0
 #define INCLUDE_xQueueGetMutexHolder 0
 #define INCLUDE_uxTaskGetStackHighWaterMark 1
 #define INCLUDE_eTaskGetState 0
+#define INCLUDE_xTaskGetCurrentTaskHandle 1
 
 void vAssertCalled(unsigned long ulLine, const char *const pcFileName);
 #define configASSERT(x)                                                        \
@@ -41,35 +41,77 @@ const uint16_t DCS_Options[104] = {
     0x01D9, 0x01DA, 0x01DC, 0x01E3, 0x01EC,
 };
 
-static uint32_t DCS_CalculateGolay(uint32_t CodeWord) {
-  unsigned int i;
-  uint32_t Word = CodeWord;
-  for (i = 0; i < 12; i++) {
-    Word <<= 1;
-    if (Word & 0x1000)
-      Word ^= 0x08EA;
-  }
-  return CodeWord | ((Word & 0x0FFE) << 11);
-}
+// Golay parity (bits 12..22) of each DCS_Options code word
+static const uint16_t DCS_Parity[104] = {
+    0x763, 0x6B7, 0x65D, 0x51F, 0x5F5, 0x0BE, 0x5B6, 0x0FD, 0x7CA, 0x355,
+    0x6F4, 0x5D1, 0x679, 0x693, 0x2E6, 0x747, 0x35E, 0x72B, 0x7C1, 0x5DA,
+    0x07B, 0x3D3, 0x339, 0x2ED, 0x37A, 0x2AE, 0x1EC, 0x44D, 0x4A7, 0x6BC,
+    0x31D, 0x05F, 0x18B, 0x6E9, 0x5AB, 0x68E, 0x75A, 0x7B0, 0x45B, 0x1FA,
+    0x58F, 0x565, 0x627, 0x6CD, 0x36C, 0x177, 0x5E8, 0x43C, 0x4D6, 0x794,
+    0x6AA, 0x0CF, 0x38D, 0x6C6, 0x196, 0x23E, 0x2D4, 0x297, 0x3A9, 0x0EB,
+    0x54A, 0x685, 0x2F0, 0x158, 0x776, 0x79C, 0x3E9, 0x4B9, 0x6C5, 0x62F,
+    0x7B8, 0x752, 0x4FA, 0x52E, 0x15B, 0x3AA, 0x27E, 0x60B, 0x6E1, 0x3C6,
+    0x2F8, 0x41B, 0x275, 0x34B, 0x0E3, 0x19E, 0x0C7, 0x5D9, 0x671, 0x0F5,
+    0x01F, 0x728, 0x7C2, 0x4C3, 0x247, 0x393, 0x22B, 0x0BD, 0x398, 0x1E4,
+    0x10E, 0x0DA, 0x14D, 0x20F,
+};
+
+// Nearest CTCSS_Options index at start of each 1.6 Hz bucket. Buckets are
+// narrower than any gap between decision boundaries, so only the next
+// option has to be checked.
+#define CTCSS_TOLERANCE 50
+#define CTCSS_MIN (670 - CTCSS_TOLERANCE + 1)
+#define CTCSS_MAX (2541 + CTCSS_TOLERANCE - 1)
+#define CTCSS_BUCKET_SHIFT 4
+
+static const uint8_t CTCSS_Buckets[124] = {
+    0, 0, 0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 16, 17, 17, 18, 18, 18, 19, 19, 19,
+    20, 20, 20, 21, 21, 21, 22, 22, 22, 23, 23, 23, 24, 24, 24, 25, 25, 25, 26,
+    27, 27, 28, 28, 29, 29, 30, 30, 31, 32, 32, 33, 33, 34, 34, 35, 35, 36, 36,
+    37, 37, 38, 38, 39, 39, 39, 40, 40, 41, 41, 42, 42, 42, 42, 43, 43, 43, 43,
+    44, 44, 44, 44, 45, 45, 46, 46, 46, 46, 47, 47, 47, 47, 47, 48, 48, 48, 48,
+    49, 49, 49, 49, 49,
+};
+
+_Static_assert(ARRAY_SIZE(CTCSS_Buckets) ==
+                   ((CTCSS_MAX - CTCSS_MIN) >> CTCSS_BUCKET_SHIFT) + 1,
+               "CTCSS bucket table size");
 
 uint32_t DCS_GetGolayCodeWord(DCS_CodeType_t CodeType, uint8_t Option) {
-  uint32_t Code = DCS_CalculateGolay(DCS_Options[Option] + 0x800U);
+  uint32_t Code = ((uint32_t)DCS_Parity[Option] << 12) | 0x800U |
+                  DCS_Options[Option];
   if (CodeType == CODE_TYPE_REVERSE_DIGITAL)
     Code ^= 0x7FFFFF;
   return Code;
 }
 
+// DCS_Options is sorted
+static int8_t DCS_FindOption(uint16_t Value) {
+  int8_t lo = 0;
+  int8_t hi = ARRAY_SIZE(DCS_Options) - 1;
+  while (lo <= hi) {
+    const int8_t mid = (lo + hi) >> 1;
+    if (DCS_Options[mid] < Value) {
+      lo = mid + 1;
+    } else if (DCS_Options[mid] > Value) {
+      hi = mid - 1;
+    } else {
+      return mid;
+    }
+  }
+  return -1;
+}
+
 uint8_t DCS_GetCdcssCode(uint32_t Code) {
   unsigned int i;
   for (i = 0; i < 23; i++) {
     uint32_t Shift;
 
     if (((Code >> 9) & 0x7U) == 4) {
-      unsigned int j;
-      for (j = 0; j < ARRAY_SIZE(DCS_Options); j++)
-        if (DCS_Options[j] == (Code & 0x1FF))
-          if (DCS_GetGolayCodeWord(2, j) == Code)
-            return j;
+      const int8_t j = DCS_FindOption(Code & 0x1FF);
+      if (j >= 0 && DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, j) == Code)
+        return j;
     }
 
     Shift = Code >> 1;
@@ -82,19 +124,13 @@ uint8_t DCS_GetCdcssCode(uint32_t Code) {
 }
 
 uint8_t DCS_GetCtcssCode(uint16_t Code) {
-  unsigned int i;
-  uint8_t Result = 0xFF;
-  int Smallest = ARRAY_SIZE(CTCSS_Options);
-
-  for (i = 0; i < ARRAY_SIZE(CTCSS_Options); i++) {
-    int Delta = Code - CTCSS_Options[i];
-    if (Delta < 0)
-      Delta = -(Code - CTCSS_Options[i]);
-    if (Smallest > Delta) {
-      Smallest = Delta;
-      Result = i;
-    }
-  }
+  if (Code < CTCSS_MIN || Code > CTCSS_MAX)
+    return 0xFF;
+
+  unsigned int i = CTCSS_Buckets[(Code - CTCSS_MIN) >> CTCSS_BUCKET_SHIFT];
+  if (i + 1 < ARRAY_SIZE(CTCSS_Options) &&
+      CTCSS_Options[i + 1] - Code < Code - CTCSS_Options[i])
+    i++;
 
-  return Result;
+  return i;
 }
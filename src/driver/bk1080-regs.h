@@ -24,11 +24,22 @@ enum BK1080_Register_t {
 	BK1080_REG_05_SYSTEM_CONFIGURATION2 = 0x05U,
 	BK1080_REG_07                       = 0x07U,
 	BK1080_REG_10                       = 0x0AU,
+	BK1080_REG_11_READ_CHANNEL          = 0x0BU,
 	BK1080_REG_25_INTERNAL              = 0x19U,
 };
 
 typedef enum BK1080_Register_t BK1080_Register_t;
 
+// REG 02
+
+#define BK1080_REG_02_SEEK			(1U << 8)
+#define BK1080_REG_02_SEEKUP			(1U << 9)
+#define BK1080_REG_02_SKMODE			(1U << 10) // stop at band limit
+
+// REG 03
+
+#define BK1080_REG_03_TUNE			(1U << 15)
+
 // REG 07
 
 #define BK1080_REG_07_SHIFT_FREQD		4
@@ -42,9 +53,13 @@ typedef enum BK1080_Register_t BK1080_Register_t;
 
 // REG 10
 
+#define BK1080_REG_10_SHIFT_STC			14
+#define BK1080_REG_10_SHIFT_SFBL		13
 #define BK1080_REG_10_SHIFT_AFCRL		12
 #define BK1080_REG_10_SHIFT_RSSI		0
 
+#define BK1080_REG_10_MASK_STC			(0x01U << BK1080_REG_10_SHIFT_STC)
+#define BK1080_REG_10_MASK_SFBL			(0x01U << BK1080_REG_10_SHIFT_SFBL)
 #define BK1080_REG_10_MASK_AFCRL		(0x01U << BK1080_REG_10_SHIFT_AFCRL)
 #define BK1080_REG_10_MASK_RSSI			(0xFFU << BK1080_REG_10_SHIFT_RSSI)
 
@@ -53,5 +68,9 @@ typedef enum BK1080_Register_t BK1080_Register_t;
 
 #define BK1080_REG_10_GET_RSSI(x)		(((x) & BK1080_REG_10_MASK_RSSI) >> BK1080_REG_10_SHIFT_RSSI)
 
+// REG 11
+
+#define BK1080_REG_11_MASK_READCHAN		0x3FFU
+
 #endif
 
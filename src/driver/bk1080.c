@@ -1,5 +1,7 @@
 #include "bk1080.h"
 #include "../inc/dp32g030/gpio.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
 #include "../misc.h"
 #include "bk1080-regs.h"
 #include "gpio.h"
@@ -15,30 +17,75 @@ static const uint16_t BK1080_RegisterTable[] = {
 
 static bool gIsInitBK1080;
 static uint32_t currentF = 0;
+static uint32_t bandStartF = 7600000;
 
 static uint16_t CH_SP_F[] = {20000, 10000, 5000};
 
+static const uint8_t CH_SP = BK1080_CHSP_100;
+
+#define STC_TIMEOUT_MS 10
+
+static bool stc(void) {
+  return BK1080_ReadRegister(BK1080_REG_10) & BK1080_REG_10_MASK_STC;
+}
+
+// STC follows tune/seek bit going low, chip takes next tune only after that
+static void waitStcClear(void) {
+  const TickType_t start = xTaskGetTickCount();
+  while (stc() &&
+         xTaskGetTickCount() - start < pdMS_TO_TICKS(STC_TIMEOUT_MS)) {
+  }
+}
+
 void BK1080_SetFrequency(uint32_t f) {
   if (f == currentF) {
     return;
   }
   currentF = f;
   uint8_t vol = 0b1111;
-  uint8_t chSp = BK1080_CHSP_100;
   uint8_t seekThres = 0b00001010;
 
   uint8_t band = f < 7600000 ? BK1080_BAND_64_76 : BK1080_BAND_76_108;
 
-  uint32_t startF = band == BK1080_BAND_64_76 ? 6400000 : 7600000;
+  bandStartF = band == BK1080_BAND_64_76 ? 6400000 : 7600000;
 
-  uint16_t channel = (f - startF) / CH_SP_F[chSp];
+  uint16_t channel = (f - bandStartF) / CH_SP_F[CH_SP];
 
-  uint16_t sysCfg2 = (vol << 0) | (chSp << 4) | (band << 6) | (seekThres << 8);
+  uint16_t sysCfg2 = (vol << 0) | (CH_SP << 4) | (band << 6) | (seekThres << 8);
 
   BK1080_WriteRegister(BK1080_REG_05_SYSTEM_CONFIGURATION2, sysCfg2);
   BK1080_WriteRegister(BK1080_REG_03_CHANNEL, channel);
-  SYS_DelayMs(10);
-  BK1080_WriteRegister(BK1080_REG_03_CHANNEL, channel | 0x8000);
+  waitStcClear();
+  BK1080_WriteRegister(BK1080_REG_03_CHANNEL, channel | BK1080_REG_03_TUNE);
+}
+
+// up from current channel, stops at band top (SKMODE); unmutes
+void BK1080_Seek(void) {
+  currentF = 0; // chip leaves tuned channel
+  BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0201);
+  waitStcClear();
+  BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION,
+                       0x0201 | BK1080_REG_02_SEEKUP | BK1080_REG_02_SEEK |
+                           BK1080_REG_02_SKMODE);
+}
+
+void BK1080_SeekCancel(void) {
+  BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0201);
+}
+
+// false while seeking, limit: stopped at band edge without station
+bool BK1080_SeekDone(uint32_t *f, bool *limit) {
+  const uint16_t status = BK1080_ReadRegister(BK1080_REG_10);
+  if (!(status & BK1080_REG_10_MASK_STC)) {
+    return false;
+  }
+  const uint16_t ch = BK1080_ReadRegister(BK1080_REG_11_READ_CHANNEL) &
+                      BK1080_REG_11_MASK_READCHAN;
+  BK1080_WriteRegister(BK1080_REG_02_POWER_CONFIGURATION, 0x0201);
+  currentF = bandStartF + ch * CH_SP_F[CH_SP];
+  *f = currentF;
+  *limit = status & BK1080_REG_10_MASK_SFBL;
+  return true;
 }
 
 void BK1080_Init(uint32_t f, bool bEnable) {
@@ -70,21 +117,25 @@ void BK1080_Init(uint32_t f, bool bEnable) {
 uint16_t BK1080_ReadRegister(BK1080_Register_t Register) {
   uint8_t Value[2];
 
+  I2C_Lock();
   I2C_Start();
   I2C_Write(0x80);
   I2C_Write((Register << 1) | I2C_READ);
   I2C_ReadBuffer(Value, sizeof(Value));
   I2C_Stop();
+  I2C_Unlock();
   return MAKE_WORD(Value[0], Value[1]);
 }
 
 void BK1080_WriteRegister(BK1080_Register_t Register, uint16_t Value) {
+  Value = ((Value >> 8) & 0xFF) | ((Value & 0xFF) << 8);
+  I2C_Lock();
   I2C_Start();
   I2C_Write(0x80);
   I2C_Write((Register << 1) | I2C_WRITE);
-  Value = ((Value >> 8) & 0xFF) | ((Value & 0xFF) << 8);
   I2C_WriteBuffer(&Value, sizeof(Value));
   I2C_Stop();
+  I2C_Unlock();
 }
 
 void BK1080_Mute(bool Mute) {
@@ -26,6 +26,9 @@ uint16_t BK1080_ReadRegister(BK1080_Register_t Register);
 void BK1080_WriteRegister(BK1080_Register_t Register, uint16_t Value);
 void BK1080_Mute(bool Mute);
 void BK1080_SetFrequency(uint32_t Frequency);
+void BK1080_Seek(void);
+bool BK1080_SeekDone(uint32_t *f, bool *limit);
+void BK1080_SeekCancel(void);
 uint16_t BK1080_GetFrequencyDeviation();
 uint16_t BK1080_GetRSSI();
 uint8_t BK1080_GetSNR();
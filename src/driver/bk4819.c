@@ -753,29 +753,6 @@ void BK4819_PlayDTMF(char Code) {
   }
 }
 
-void BK4819_PlayDTMFString(const char *pString, bool bDelayFirst,
-                           uint16_t FirstCodePersistTime,
-                           uint16_t HashCodePersistTime,
-                           uint16_t CodePersistTime,
-                           uint16_t CodeInternalTime) {
-  uint16_t delay;
-
-  for (uint8_t i = 0; pString[i]; i++) {
-    BK4819_PlayDTMF(pString[i]);
-    BK4819_ExitTxMute();
-    if (bDelayFirst && i == 0) {
-      delay = FirstCodePersistTime;
-    } else if (pString[i] == '*' || pString[i] == '#') {
-      delay = HashCodePersistTime;
-    } else {
-      delay = CodePersistTime;
-    }
-    SYS_DelayMs(delay);
-    BK4819_EnterTxMute();
-    SYS_DelayMs(CodeInternalTime);
-  }
-}
-
 void BK4819_TransmitTone(uint32_t Frequency) {
   BK4819_EnterTxMute();
   BK4819_WriteRegister(BK4819_REG_70,
@@ -907,52 +884,6 @@ uint8_t BK4819_GetCTCType(void) {
   return (BK4819_ReadRegister(BK4819_REG_0C) >> 10) & 3;
 }
 
-void BK4819_PlayRoger(void) {
-  const uint16_t M[] = {1540, 80, 0, 80, 1310, 80, 0, 0};
-  BK4819_PlaySequence(M);
-}
-
-void BK4819_PlayRogerTiny(void) {
-  const uint16_t M[] = {1250, 30, 0, 50, 1500, 30, 750, 30, 0, 0};
-  BK4819_PlaySequence(M);
-}
-
-void BK4819_PlayRogerStalk1(void) {
-  BK4819_PlaySequence((uint16_t[]){1975, 80, 0, 10, 2100, 100, 0, 10, 3140, 80,
-                                   0, 10, 2800, 100, 0, 10, 0, 0});
-}
-
-void BK4819_PlaySequence(const uint16_t *M) {
-  bool initialTone = true;
-  for (uint8_t i = 0; i < 255; i += 2) {
-    uint16_t note = M[i];
-    uint16_t t = M[i + 1];
-    if (!note && !t) {
-      break;
-    }
-    if (initialTone) {
-      initialTone = false;
-      BK4819_TransmitTone(note);
-      if (gSettings.toneLocal) {
-        SYS_DelayMs(10);
-        AUDIO_ToggleSpeaker(true);
-      }
-    } else {
-      BK4819_SetToneFrequency(note);
-      BK4819_ExitTxMute();
-    }
-    if (note && !t) {
-      return;
-    }
-    SYS_DelayMs(t);
-  }
-  if (gSettings.toneLocal) {
-    AUDIO_ToggleSpeaker(false);
-    SYS_DelayMs(10);
-  }
-  BK4819_EnterTxMute();
-}
-
 void BK4819_Enable_AfDac_DiscMode_TxDsp(void) {
   BK4819_Idle();
   BK4819_WriteRegister(BK4819_REG_30, 0x0302);
@@ -144,10 +144,6 @@ void BK4819_ExitDTMF_TX(bool bKeep);
 void BK4819_EnableTXLink(void);
 
 void BK4819_PlayDTMF(char Code);
-void BK4819_PlayDTMFString(const char *pString, bool bDelayFirst,
-                           uint16_t FirstCodePersistTime,
-                           uint16_t HashCodePersistTime,
-                           uint16_t CodePersistTime, uint16_t CodeInternalTime);
 
 void BK4819_TransmitTone(uint32_t Frequency);
 
@@ -177,11 +173,7 @@ uint8_t BK4819_GetDTMF_5TONE_Code(void);
 uint8_t BK4819_GetCDCSSCodeType(void);
 uint8_t BK4819_GetCTCType(void);
 
-void BK4819_PlaySequence(const uint16_t *M);
-void BK4819_PlayRoger(void);
-void BK4819_PlayRogerTiny(void);
 void BK4819_PlayRogerMDC(void);
-void BK4819_PlayRogerStalk1(void);
 
 void BK4819_Enable_AfDac_DiscMode_TxDsp(void);
 
@@ -1,26 +1,55 @@
 #include "../driver/eeprom.h"
 #include "../driver/i2c.h"
-#include "../driver/system.h"
+#include "../driver/systick.h"
 #include "../settings.h"
 #include "uart.h"
 #include <stddef.h>
 #include <string.h>
 
 bool gEepromWrite = false;
+EEPROMStats gEepromStats;
 
 static uint8_t tmpBuffer[128];
 
+// Chip acks its address again once write cycle is over (10 ms at most).
+// Called with I2C lock held, so no other reader hits the busy chip.
+static void waitWriteCycle(uint8_t IIC_ADD) {
+  for (uint8_t i = 0; i < 100; ++i) {
+    I2C_Start();
+    const bool ack = I2C_Write(IIC_ADD) == 0;
+    I2C_Stop();
+    if (ack) {
+      return;
+    }
+    SYSTICK_DelayUs(100);
+  }
+}
+
+// Sequential read runs across pages, only the 64K block (device address)
+// boundary needs a new transfer
 void EEPROM_ReadBuffer(uint32_t address, void *pBuffer, uint16_t size) {
-  uint8_t IIC_ADD = 0xA0 | (address >> 15 & 14);
+  uint8_t *p = pBuffer;
 
-  I2C_Start();
-  I2C_Write(IIC_ADD);
-  I2C_Write((address >> 8) & 0xFF);
-  I2C_Write(address & 0xFF);
-  I2C_Start();
-  I2C_Write(IIC_ADD + 1);
-  I2C_ReadBuffer(pBuffer, size);
-  I2C_Stop();
+  while (size) {
+    uint32_t blockRest = 0x10000 - (address & 0xFFFF);
+    uint16_t n = size < blockRest ? size : blockRest;
+    uint8_t IIC_ADD = 0xA0 | (address >> 15 & 14);
+
+    I2C_Lock();
+    I2C_Start();
+    I2C_Write(IIC_ADD);
+    I2C_Write((address >> 8) & 0xFF);
+    I2C_Write(address & 0xFF);
+    I2C_Start();
+    I2C_Write(IIC_ADD + 1);
+    I2C_ReadBuffer(p, n);
+    I2C_Stop();
+    I2C_Unlock();
+
+    p += n;
+    address += n;
+    size -= n;
+  }
 }
 
 void EEPROM_WriteBuffer(uint32_t address, void *pBuffer, uint16_t size) {
@@ -39,6 +68,7 @@ void EEPROM_WriteBuffer(uint32_t address, void *pBuffer, uint16_t size) {
     if (memcmp(pBuffer, tmpBuffer, n) != 0) {
       uint8_t IIC_ADD = 0xA0 | (address >> 15 & 14);
 
+      I2C_Lock();
       I2C_Start();
       I2C_Write(IIC_ADD);
       I2C_Write((address >> 8) & 0xFF);
@@ -47,7 +77,12 @@ void EEPROM_WriteBuffer(uint32_t address, void *pBuffer, uint16_t size) {
       I2C_WriteBuffer(pBuffer, n);
 
       I2C_Stop();
-      SYS_DelayMs(10);
+      waitWriteCycle(IIC_ADD);
+      I2C_Unlock();
+      gEepromStats.pageWrites++;
+      gEepromStats.bytes += n;
+    } else {
+      gEepromStats.pagesSkipped++;
     }
 
     pBuffer += n;
@@ -64,6 +99,7 @@ void EEPROM_ClearPage(uint16_t page) {
 
   uint8_t IIC_ADD = 0xA0 | (address >> 15 & 14);
 
+  I2C_Lock();
   I2C_Start();
   I2C_Write(IIC_ADD);
   I2C_Write((address >> 8) & 0xFF);
@@ -74,7 +110,10 @@ void EEPROM_ClearPage(uint16_t page) {
   }
 
   I2C_Stop();
-  SYS_DelayMs(10);
+  waitWriteCycle(IIC_ADD);
+  I2C_Unlock();
 
+  gEepromStats.pageWrites++;
+  gEepromStats.bytes += PAGE_SIZE;
   gEepromWrite = true;
 }
@@ -4,7 +4,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+typedef struct {
+  uint32_t pageWrites;   // physical page program cycles
+  uint32_t pagesSkipped; // identical content, write avoided
+  uint32_t bytes;
+} EEPROMStats;
+
 extern bool gEepromWrite;
+extern EEPROMStats gEepromStats;
 
 void EEPROM_ReadBuffer(uint32_t Address, void *pBuffer, uint16_t Size);
 void EEPROM_WriteBuffer(uint32_t Address, void *pBuffer, uint16_t Size);
@@ -1,32 +1,52 @@
 #include "i2c.h"
-#include "../external/CMSIS_5/Device/ARM/ARMCM0/Include/ARMCM0.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/semphr.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../inc/dp32g030/portcon.h"
 #include "gpio.h"
-#include "systick.h"
+#include "system.h"
+
+// ~4 cycles per loop (subs + taken bne), 16 loops + GPIO access give
+// >= 1.3us low / 0.6us high, i.e. fast mode (~350-400 kHz) at 48 MHz
+#define I2C_FAST_LOOPS (CPU_CLOCK_HZ / 4 / 750000)
+
+static StaticSemaphore_t mutexBuffer;
+static SemaphoreHandle_t mutex;
+
+static inline void delay(void) {
+  uint32_t n = I2C_FAST_LOOPS;
+  __asm volatile("1: subs %0, #1\n"
+                 "   bne 1b\n"
+                 : "+l"(n));
+}
+
+void I2C_Init(void) { mutex = xSemaphoreCreateMutexStatic(&mutexBuffer); }
+
+// GPIOA also carries keypad rows, so the keyboard scan takes this too
+void I2C_Lock(void) { xSemaphoreTake(mutex, portMAX_DELAY); }
+
+void I2C_Unlock(void) { xSemaphoreGive(mutex); }
 
 void I2C_Start(void) {
-  __disable_irq();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
 }
 
 void I2C_Stop(void) {
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
-  SYSTICK_DelayUs(1);
-  __enable_irq();
+  delay();
 }
 
 uint8_t I2C_Read(bool bFinal) {
@@ -39,33 +59,33 @@ uint8_t I2C_Read(bool bFinal) {
   Data = 0;
   for (i = 0; i < 8; i++) {
     GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-    SYSTICK_DelayUs(1);
+    delay();
     GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-    SYSTICK_DelayUs(1);
+    delay();
     Data <<= 1;
-    SYSTICK_DelayUs(1);
+    delay();
     if (GPIO_CheckBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA)) {
       Data |= 1U;
     }
     GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-    SYSTICK_DelayUs(1);
+    delay();
   }
 
   PORTCON_PORTA_IE &= ~PORTCON_PORTA_IE_A11_MASK;
   PORTCON_PORTA_OD |= PORTCON_PORTA_OD_A11_BITS_ENABLE;
   GPIOA->DIR |= GPIO_DIR_11_BITS_OUTPUT;
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   if (bFinal) {
     GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
   } else {
     GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
   }
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
 
   return Data;
 }
@@ -75,7 +95,7 @@ int I2C_Write(uint8_t Data) {
   int ret = -1;
 
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   for (i = 0; i < 8; i++) {
     if ((Data & 0x80) == 0) {
       GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
@@ -83,20 +103,20 @@ int I2C_Write(uint8_t Data) {
       GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
     }
     Data <<= 1;
-    SYSTICK_DelayUs(1);
+    delay();
     GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-    SYSTICK_DelayUs(1);
+    delay();
     GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-    SYSTICK_DelayUs(1);
+    delay();
   }
 
   PORTCON_PORTA_IE |= PORTCON_PORTA_IE_A11_BITS_ENABLE;
   PORTCON_PORTA_OD &= ~PORTCON_PORTA_OD_A11_MASK;
   GPIOA->DIR &= ~GPIO_DIR_11_MASK;
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA);
-  SYSTICK_DelayUs(1);
+  delay();
   GPIO_SetBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
 
   for (i = 0; i < 255; i++) {
     if (GPIO_CheckBit(&GPIOA->DATA, GPIOA_PIN_I2C_SDA) == 0) {
@@ -106,7 +126,7 @@ int I2C_Write(uint8_t Data) {
   }
 
   GPIO_ClearBit(&GPIOA->DATA, GPIOA_PIN_I2C_SCL);
-  SYSTICK_DelayUs(1);
+  delay();
   PORTCON_PORTA_IE &= ~PORTCON_PORTA_IE_A11_MASK;
   PORTCON_PORTA_OD |= PORTCON_PORTA_OD_A11_BITS_ENABLE;
   GPIOA->DIR |= GPIO_DIR_11_BITS_OUTPUT;
@@ -119,12 +139,16 @@ uint16_t I2C_ReadBuffer(void *pBuffer, uint16_t Size) {
   uint8_t *pData = (uint8_t *)pBuffer;
   uint16_t i;
 
+  if (!Size) {
+    return 0;
+  }
+
   for (i = 0; i < Size - 1; i++) {
-    SYSTICK_DelayUs(1);
+    delay();
     pData[i] = I2C_Read(false);
   }
 
-  SYSTICK_DelayUs(1);
+  delay();
   pData[i++] = I2C_Read(true);
 
   return Size;
@@ -9,6 +9,10 @@ enum {
   I2C_READ = 1U,
 };
 
+void I2C_Init(void);
+void I2C_Lock(void);
+void I2C_Unlock(void);
+
 void I2C_Start(void);
 void I2C_Stop(void);
 
@@ -6,6 +6,7 @@
 #include "../system.h"
 #include "FreeRTOS.h"
 #include "gpio.h"
+#include "i2c.h"
 #include "systick.h"
 #include "task.h"
 
@@ -143,8 +144,11 @@ static uint8_t ScanKeyboardMatrix() {
 
 void KEYBOARD_Poll(void) {
   HandlePttKey();
+  // row writes to GPIOA->DATA must not interleave with I2C bit-banging
+  I2C_Lock();
   mKeyPressed = ScanKeyboardMatrix();
   ResetKeyboardPins();
+  I2C_Unlock();
 }
 
 void KEYBOARD_CheckKeys() {
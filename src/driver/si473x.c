@@ -1,6 +1,7 @@
 #include "si473x.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../misc.h"
+#include "../scheduler.h"
 #include "../settings.h"
 #include "../system.h"
 #include "audio.h"
@@ -23,42 +24,138 @@ SI47XX_MODE si4732mode = SI47XX_FM;
 uint16_t siCurrentFreq = 0;
 bool isSi4732On = false;
 
+#define CTS_TIMEOUT_MS 300
+#define SHADOW_SIZE 24
+
+// last values written to chip, chip resets them all on power up
+typedef struct {
+  uint16_t prop;
+  uint16_t value;
+} PropShadow;
+
+static PropShadow shadow[SHADOW_SIZE];
+static uint8_t shadowCount = 0;
+static uint8_t shadowNext = 0;
+
+static void shadowReset() {
+  shadowCount = 0;
+  shadowNext = 0;
+}
+
+static PropShadow *shadowFind(uint16_t prop) {
+  for (uint8_t i = 0; i < shadowCount; ++i) {
+    if (shadow[i].prop == prop) {
+      return &shadow[i];
+    }
+  }
+  return NULL;
+}
+
+static void shadowSet(uint16_t prop, uint16_t value) {
+  PropShadow *e = shadowFind(prop);
+  if (!e) {
+    e = &shadow[shadowNext];
+    shadowNext = (shadowNext + 1) % SHADOW_SIZE;
+    if (shadowCount < SHADOW_SIZE) {
+      shadowCount++;
+    }
+  }
+  e->prop = prop;
+  e->value = value;
+}
+
 static uint16_t fDiv() { return si4732mode == SI47XX_FM ? 1000 : 100; }
 
-void SI47XX_ReadBuffer(uint8_t *buf, uint8_t size) {
+static void readRaw(uint8_t *buf, uint8_t size) {
   I2C_Start();
   I2C_Write(SI47XX_I2C_ADDR + 1);
   I2C_ReadBuffer(buf, size);
   I2C_Stop();
 }
 
-void SI47XX_WriteBuffer(uint8_t *buf, uint8_t size) {
+static void writeRaw(const uint8_t *buf, uint8_t size) {
   I2C_Start();
   I2C_Write(SI47XX_I2C_ADDR);
   I2C_WriteBuffer(buf, size);
   I2C_Stop();
 }
 
+void SI47XX_ReadBuffer(uint8_t *buf, uint8_t size) {
+  I2C_Lock();
+  readRaw(buf, size);
+  I2C_Unlock();
+}
+
 bool SI47XX_IsSSB() {
   return si4732mode == SI47XX_USB || si4732mode == SI47XX_LSB;
 }
 
-void waitToSend() {
+// bus must be locked. Status read is a full bus transaction (~30us in fast
+// mode), no need to sleep between polls. Returns polls done, 0 on timeout
+static uint16_t waitCts() {
   uint8_t tmp = 0;
+  uint16_t polls = 0;
+  const TickType_t start = xTaskGetTickCount();
   do {
-    SYSTICK_Delay250ns(1);
-    SI47XX_ReadBuffer((uint8_t *)&tmp, 1);
-  } while (!(tmp & STATUS_CTS));
+    readRaw(&tmp, 1);
+    polls++;
+    if (tmp & STATUS_CTS) {
+      return polls;
+    }
+  } while (xTaskGetTickCount() - start < pdMS_TO_TICKS(CTS_TIMEOUT_MS));
+  Log("SI CTS timeout, status=%02X", tmp);
+  return 0;
+}
+
+// Whole command under one bus lock: CTS, command, then with resp CTS again
+// and response read. Else a command from another task (RDS service vs
+// appU) gets in between and each side reads the other's response.
+static bool command(const uint8_t *cmd, uint8_t cmdSize, uint8_t *resp,
+                    uint8_t respSize) {
+  I2C_Lock();
+  bool ok = waitCts() != 0;
+  writeRaw(cmd, cmdSize);
+  if (resp) {
+    ok = waitCts() != 0;
+    readRaw(resp, respSize);
+  }
+  I2C_Unlock();
+  return ok;
+}
+
+typedef enum {
+  OP_PROP,
+  OP_TUNE,
+  OP_POWER_UP,
+  OP_COUNT,
+} SiOp;
+
+static const char *OP_NAMES[OP_COUNT] = {"prop", "tune", "power up"};
+static TickType_t opMax[OP_COUNT];
+
+// Only new worst case per op is logged: Log blocks on UART, so logging each
+// property write or tune would cost more than what it measures.
+// Ticks are 100us, latency printed as ms with one decimal.
+static void logLatency(SiOp op, uint16_t arg, TickType_t start) {
+  const TickType_t t = xTaskGetTickCount() - start;
+  if (t <= opMax[op]) {
+    return;
+  }
+  opMax[op] = t;
+  const uint32_t us100 = t * (10000 / configTICK_RATE_HZ);
+  Log("SI %s %04X max %u.%ums", OP_NAMES[op], arg, us100 / 10, us100 % 10);
 }
 
+// Next EEPROM block is read right after last chunk of current one is sent,
+// while chip is busy with it. Bus is shared, so no more overlap is possible.
 void SI47XX_downloadPatch() {
-  // Log("DL patch");
   SYS_MsgNotify("Wait!", 10000);
   vTaskDelay(pdMS_TO_TICKS(100));
 
   uint8_t buf[64]; // 64 is optimal, more has no sense
   const uint16_t BUF_SIZE = ARRAY_SIZE(buf);
   const uint32_t PATCH_START = SETTINGS_GetEEPROMSize() - PATCH_SIZE;
+  uint32_t extraPolls = 0;
 
   for (uint16_t offset = 0; offset < PATCH_SIZE; offset += BUF_SIZE) {
     const uint32_t rest = PATCH_SIZE - offset;
@@ -66,28 +163,38 @@ void SI47XX_downloadPatch() {
     EEPROM_ReadBuffer(PATCH_START + offset, buf, eepromN);
 
     for (uint16_t i = 0; i < eepromN; i += 8) {
-      waitToSend();
-      SI47XX_WriteBuffer(buf + i, 8);
+      I2C_Lock();
+      const uint16_t polls = waitCts();
+      writeRaw(buf + i, 8);
+      I2C_Unlock();
+      extraPolls += polls ? polls - 1 : 0;
     }
   }
   SYS_MsgNotify("", 0);
-  // Log("DL patch OK");
+  Log("SI patch %u B, %u extra CTS polls", PATCH_SIZE, extraPolls);
 }
 
 void sendProperty(uint16_t prop, uint16_t parameter) {
-  waitToSend();
+  const PropShadow *e = shadowFind(prop);
+  if (e && e->value == parameter) {
+    return;
+  }
+
+  const TickType_t start = xTaskGetTickCount();
   uint8_t tmp[6] = {CMD_SET_PROPERTY, 0, prop >> 8, prop & 0xff, parameter >> 8,
                     parameter & 0xff};
-  SI47XX_WriteBuffer(tmp, 6);
-  SYS_DelayMs(8); // irrespective of CTS coming up earlier than that
+  uint8_t status;
+  // property is applied when CTS comes back
+  if (command(tmp, 6, &status, 1)) {
+    shadowSet(prop, parameter);
+  }
+  logLatency(OP_PROP, prop, start);
 }
 
 uint16_t getProperty(uint16_t prop, bool *valid) {
   uint8_t response[4] = {0};
   uint8_t tmp[4] = {CMD_GET_PROPERTY, 0, prop >> 8, prop & 0xff};
-  waitToSend();
-  SI47XX_WriteBuffer(tmp, 4);
-  SI47XX_ReadBuffer(response, 4);
+  command(tmp, 4, response, 4);
 
   if (valid) {
     *valid = !(response[0] & STATUS_ERR);
@@ -102,9 +209,7 @@ void RSQ_GET() {
     cmd[0] = CMD_AM_RSQ_STATUS;
   }
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 2);
-  SI47XX_ReadBuffer(rsqStatus.raw, si4732mode == SI47XX_FM ? 8 : 6);
+  command(cmd, 2, rsqStatus.raw, si4732mode == SI47XX_FM ? 8 : 6);
 }
 
 void SI47XX_SetVolume(uint8_t volume) {
@@ -147,20 +252,19 @@ void SI47XX_SetAutomaticGainControl(uint8_t AGCDIS, uint8_t AGCIDX) {
   agc.arg.AGCDIS = AGCDIS;
   agc.arg.AGCIDX = AGCIDX;
 
-  waitToSend();
-
   uint8_t cmd2[] = {cmd, agc.raw[0], agc.raw[1]};
-  SI47XX_WriteBuffer(cmd2, 3);
+  command(cmd2, 3, NULL, 0);
 }
 
 void SI47XX_PowerUp() {
+  const TickType_t start = xTaskGetTickCount();
+  shadowReset();
   RST_HIGH;
   uint8_t cmd[3] = {CMD_POWER_UP, FLG_XOSCEN | FUNC_FM, OUT_ANALOG};
   if (si4732mode == SI47XX_AM) {
     cmd[1] = FLG_XOSCEN | FUNC_AM;
   }
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 3);
+  command(cmd, 3, NULL, 0);
   SYS_DelayMs(500);
 
   isSi4732On = true;
@@ -178,6 +282,7 @@ void SI47XX_PowerUp() {
     setAvcAmMaxGain(40);
   }
   SI47XX_SetFreq(siCurrentFreq);
+  logLatency(OP_POWER_UP, si4732mode, start);
 }
 
 void SI47XX_SsbSetup(SI47XX_SsbFilterBW AUDIOBW, uint8_t SBCUTFLT,
@@ -194,10 +299,12 @@ void SI47XX_SsbSetup(SI47XX_SsbFilterBW AUDIOBW, uint8_t SBCUTFLT,
 }
 
 void SI47XX_PatchPowerUp() {
+  const uint32_t start = Now();
+
+  shadowReset();
   RST_HIGH;
   uint8_t cmd[3] = {CMD_POWER_UP, 0b00110001, OUT_ANALOG};
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 3);
+  command(cmd, 3, NULL, 0);
   SYS_DelayMs(60);
 
   isSi4732On = true;
@@ -216,13 +323,17 @@ void SI47XX_PatchPowerUp() {
 
   si4732mode = SI47XX_USB; // FIXME: modulation must be set before power on to
                            // prevent repowering
+
+  Log("SSB ready in %ums", Now() - start);
 }
 
 void SI47XX_SetSsbBandwidth(SI47XX_SsbFilterBW bw) {
   SI47XX_SsbSetup(bw, 1, 0, 1, 0, 1);
 }
 
+// stale STC of previous tune is acked first, see SI47XX_SeekDone
 void SI47XX_Seek(bool up, bool wrap) {
+  SI47xx_GetStatus(1, 0);
   uint8_t seekOpt = (up ? FLG_SEEKUP : 0) | (wrap ? FLG_WRAP : 0);
   uint8_t cmd[6] = {CMD_FM_SEEK_START, seekOpt, 0x00, 0x00, 0x00, 0x00};
 
@@ -231,8 +342,38 @@ void SI47XX_Seek(bool up, bool wrap) {
     cmd[5] = (siCurrentFreq > 1800) ? 1 : 0;
   }
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, si4732mode == SI47XX_FM ? 2 : 6);
+  command(cmd, si4732mode == SI47XX_FM ? 2 : 6, NULL, 0);
+}
+
+// false while seek is running, status byte read only, no command sent
+bool SI47XX_SeekDone(SI47XX_SeekResult *r) {
+  uint8_t status = 0;
+  SI47XX_ReadBuffer(&status, 1);
+  if (!(status & STATUS_STCINT)) {
+    return false;
+  }
+
+  uint8_t cmd[2] = {CMD_FM_TUNE_STATUS, TUNE_STATUS_ARG1_CLEAR_INT};
+  if (si4732mode != SI47XX_FM) {
+    cmd[0] = CMD_AM_TUNE_STATUS;
+  }
+  uint8_t response[6] = {0};
+
+  command(cmd, 2, response, 6);
+
+  siCurrentFreq = MAKE_WORD(response[2], response[3]);
+  r->f = siCurrentFreq * fDiv();
+  r->limit = response[1] & FIELD_TUNE_STATUS_RESP1_SEEK_LIMIT;
+  r->valid = response[1] & FIELD_TUNE_STATUS_RESP1_VALID;
+  r->rssi = response[4];
+  r->snr = response[5];
+  return true;
+}
+
+// chip stays where seek was, next tune is not skipped
+void SI47XX_SeekCancel(void) {
+  SI47xx_GetStatus(1, 1);
+  siCurrentFreq = 0;
 }
 
 uint32_t SI47XX_getFrequency(bool *valid) {
@@ -243,9 +384,7 @@ uint32_t SI47XX_getFrequency(bool *valid) {
     cmd[0] = CMD_AM_TUNE_STATUS;
   }
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 1);
-  SI47XX_ReadBuffer(response, 4);
+  command(cmd, 1, response, 4);
 
   if (valid) {
     *valid = (response[1] & STATUS_VALID);
@@ -258,11 +397,11 @@ void SI47XX_PowerDown() {
   AUDIO_ToggleSpeaker(false);
   uint8_t cmd[1] = {CMD_POWER_DOWN};
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 1);
+  command(cmd, 1, NULL, 0);
   SYSTICK_Delay250ns(10);
   RST_LOW;
   isSi4732On = false;
+  shadowReset();
   siCurrentFreq = 0;
 }
 
@@ -308,10 +447,11 @@ void SI47XX_SetFreq(uint16_t freq) {
     cmd[5] = 1;
   }
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, size);
+  const TickType_t start = xTaskGetTickCount();
+  uint8_t status;
+  command(cmd, size, &status, 1);
   siCurrentFreq = freq;
-  Log("SI f=%u", siCurrentFreq);
+  logLatency(OP_TUNE, freq, start);
 }
 
 void SI47XX_SetAMFrontendAGC(uint8_t minGainIdx, uint8_t attnBackup) {
@@ -327,9 +467,7 @@ void SI47XX_SetBandwidth(SI47XX_FilterBW AMCHFLT, bool AMPLFLT) {
 
 void SI47XX_ReadRDS(uint8_t buf[13]) {
   uint8_t cmd[2] = {CMD_FM_RDS_STATUS, RDS_STATUS_ARG1_CLEAR_INT};
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 2);
-  SI47XX_ReadBuffer(buf, 13);
+  command(cmd, 2, buf, 13);
 }
 
 void SI47XX_SetSeekFmLimits(uint32_t bottom, uint32_t top) {
@@ -402,9 +540,7 @@ void SI47xx_GetStatus(uint8_t intack, uint8_t cancel) {
 
   uint8_t response[4] = {0};
 
-  waitToSend();
-  SI47XX_WriteBuffer(cmdA, 2);
-  SI47XX_ReadBuffer(response, 4);
+  command(cmdA, 2, response, 4);
 
   /* if (valid) {
     *valid = !(response[0] & STATUS_ERR);
@@ -567,6 +567,14 @@ typedef union {
   uint8_t raw[2];
 } SI47XX_BW_Config; // AM_CHANNEL_FILTER
 
+typedef struct {
+  uint32_t f;
+  uint8_t rssi; // dBuV
+  uint8_t snr;  // dB
+  bool valid;
+  bool limit; // band edge reached, no station
+} SI47XX_SeekResult;
+
 void SI47XX_PowerUp();
 void SI47XX_PatchPowerUp();
 void SI47XX_PowerDown();
@@ -577,6 +585,8 @@ bool SI47XX_IsSSB();
 void RSQ_GET();
 void SI47XX_SetAutomaticGainControl(uint8_t AGCDIS, uint8_t AGCIDX);
 void SI47XX_Seek(bool up, bool wrap);
+bool SI47XX_SeekDone(SI47XX_SeekResult *r);
+void SI47XX_SeekCancel(void);
 uint32_t SI47XX_getFrequency(bool *valid);
 void SI47XX_SetBandwidth(SI47XX_FilterBW AMCHFLT, bool AMPLFLT);
 void SI47XX_SetSsbBandwidth(SI47XX_SsbFilterBW bw);
@@ -1,6 +1,8 @@
 #include "st7565.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../inc/dp32g030/spi.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
 #include "../misc.h"
 #include "../settings.h"
 #include "gpio.h"
@@ -21,13 +23,16 @@ uint8_t gFrameBuffer[8][LCD_WIDTH];
 
 bool gRedrawScreen = true;
 
+// power-up waits sleep instead of spinning, so other boot stages can run
+static void sleepMs(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+
 static void ST7565_Configure_GPIO_B11(void) {
   GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_RES);
-  SYS_DelayMs(1);
+  sleepMs(1);
   GPIO_ClearBit(&GPIOB->DATA, GPIOB_PIN_ST7565_RES);
-  SYS_DelayMs(20);
+  sleepMs(20);
   GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_RES);
-  SYS_DelayMs(120);
+  sleepMs(120);
 }
 
 static void ST7565_SelectColumnAndLine(uint8_t Column, uint8_t Line) {
@@ -84,7 +89,7 @@ void ST7565_Init(bool full) {
     ST7565_Configure_GPIO_B11();
     SPI_ToggleMasterMode(&SPI0->CR, false);
     ST7565_WriteByte(0xE2);
-    SYS_DelayMs(120);
+    sleepMs(120);
   } else {
     SPI_ToggleMasterMode(&SPI0->CR, false);
   }
@@ -101,15 +106,15 @@ void ST7565_Init(bool full) {
   if (full) {
     // setup power circuit
     ST7565_WriteByte(0x2B);
-    SYS_DelayMs(1);
+    sleepMs(1);
     ST7565_WriteByte(0x2E);
-    SYS_DelayMs(1);
+    sleepMs(1);
 
     // power circuit v1 v2 v3 v4
     for (uint8_t i = 0; i < 4; ++i) {
       ST7565_WriteByte(0x2F);
     }
-    SYS_DelayMs(40);
+    sleepMs(40);
   }
 
   ST7565_WriteByte(0x40);
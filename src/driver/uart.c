@@ -1,17 +1,27 @@
 #include "../inc/dp32g030/uart.h"
 #include "../external/CMSIS_5/Device/ARM/ARMCM0/Include/ARMCM0.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/semphr.h"
+#include "../external/FreeRTOS/include/task.h"
 #include "../external/printf/printf.h"
 #include "../inc/dp32g030/dma.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../inc/dp32g030/syscon.h"
+#include "../helper/latency.h"
+#include "../helper/nvring.h"
+#include "../helper/probe.h"
+#include "../misc.h"
 #include "../scheduler.h"
+#include "../ui/spectrum.h"
 #include "bk4819-regs.h"
 #include "bk4819.h"
 #include "crc.h"
 #include "eeprom.h"
 #include "gpio.h"
+#include "st7565.h"
 #include "uart.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 static const char Version[] = "s0v4";
@@ -20,7 +30,20 @@ static uint8_t UART_DMA_Buffer[256];
 
 static bool bIsInLockScreen = false;
 
+// frames queued from app tasks, drained into HW FIFO by UART_TxPump
+#define TX_QUEUE_SIZE 320 // two spectrum frames
+
+static uint8_t txQueue[TX_QUEUE_SIZE];
+static volatile uint16_t txHead;
+static volatile uint16_t txTail;
+
+// held over a whole blocking write (reply, log line), pump skips meanwhile,
+// so a queued frame can't get between header, body and footer
+static StaticSemaphore_t txMutexBuffer;
+static SemaphoreHandle_t txMutex;
+
 void UART_Init(void) {
+  txMutex = xSemaphoreCreateMutexStatic(&txMutexBuffer);
   uint32_t Delta;
   uint32_t Positive;
   uint32_t Frequency;
@@ -75,7 +98,65 @@ void UART_Init(void) {
   UART1->CTRL |= UART_CTRL_UARTEN_BITS_ENABLE;
 }
 
-void UART_Send(const void *pBuffer, uint32_t Size) {
+static bool isTxFifoFull(void) {
+  return (UART1->IF & UART_IF_TXFIFO_FULL_MASK) !=
+         UART_IF_TXFIFO_FULL_BITS_NOT_SET;
+}
+
+static void txDrain(bool wait) {
+  while (txTail != txHead) {
+    if (isTxFifoFull()) {
+      if (!wait) {
+        return;
+      }
+      continue;
+    }
+    UART1->TDR = txQueue[txTail];
+    txTail = (txTail + 1) % TX_QUEUE_SIZE;
+  }
+}
+
+// before scheduler start, with it suspended, in ISR or critical section
+// (fatal hooks) nothing can get in between, and taking mutex isn't allowed
+static bool txLock(void) {
+  if (__get_IPSR() || __get_PRIMASK() ||
+      xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+    return false;
+  }
+  xSemaphoreTake(txMutex, portMAX_DELAY);
+  return true;
+}
+
+static void txUnlock(bool locked) {
+  if (locked) {
+    xSemaphoreGive(txMutex);
+  }
+}
+
+void UART_TxPump(void) {
+  if (xSemaphoreTake(txMutex, 0) != pdTRUE) {
+    return; // blocking write in progress, it drains queue itself
+  }
+  txDrain(false);
+  xSemaphoreGive(txMutex);
+}
+
+static uint16_t txFree(void) {
+  return (txTail + TX_QUEUE_SIZE - txHead - 1) % TX_QUEUE_SIZE;
+}
+
+static void txPush(const void *p, uint16_t n) {
+  const uint8_t *pData = (const uint8_t *)p;
+  uint16_t head = txHead;
+  while (n--) {
+    txQueue[head] = *pData++;
+    head = (head + 1) % TX_QUEUE_SIZE;
+  }
+  txHead = head;
+}
+
+// caller holds TX lock and has drained queue
+static void sendRaw(const void *pBuffer, uint32_t Size) {
   const uint8_t *pData = (const uint8_t *)pBuffer;
   uint32_t i;
 
@@ -87,6 +168,13 @@ void UART_Send(const void *pBuffer, uint32_t Size) {
   }
 }
 
+void UART_Send(const void *pBuffer, uint32_t Size) {
+  const bool locked = txLock();
+  txDrain(true); // queued frames go out first
+  sendRaw(pBuffer, Size);
+  txUnlock(locked);
+}
+
 #define DMA_INDEX(x, y) (((x) + (y)) % sizeof(UART_DMA_Buffer))
 
 typedef struct {
@@ -186,6 +274,134 @@ typedef struct {
   uint32_t Timestamp;
 } CMD_052F_t;
 
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Seq;
+    uint16_t Evictions;
+    uint8_t Live;
+    uint8_t Slots;
+    uint16_t Writes[NVRING_SLOTS];
+  } Data;
+} REPLY_0541_t;
+
+typedef struct {
+  Header_t Header;
+  bool bEnable;
+  uint8_t Padding[3];
+} CMD_0542_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    bool bEnabled;
+    uint8_t Padding;
+    uint16_t MaxCostTicks; // 0.1 ms
+    uint32_t Frames;
+    uint32_t Dropped;
+  } Data;
+} REPLY_0543_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Timestamp; // ms since boot
+    uint32_t StartF;    // 10 Hz units
+    uint32_t EndF;
+    uint32_t Step;
+    uint16_t Seq;
+    uint8_t Count;
+    uint8_t Padding;
+    uint8_t Rssi[128]; // RSSI / 2, dBm = value - 160
+  } Data;
+} REPLY_0544_t;
+
+typedef struct {
+  Header_t Header;
+  bool bEnable;
+  uint8_t Padding;
+  uint16_t IntervalMs; // 0: default
+} CMD_0545_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    bool bEnabled;
+    uint8_t Padding;
+    uint16_t IntervalMs;
+    uint32_t Frames;
+    uint32_t Pages;
+    uint32_t Bytes; // page payload, before framing
+    uint32_t Deferred;
+  } Data;
+} REPLY_0546_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint16_t Seq;
+    uint8_t Page;
+    uint8_t Encoding; // SCREEN_RAW or SCREEN_RLE
+    uint8_t Len;
+    uint8_t Padding[3];
+    uint8_t Bytes[LCD_WIDTH];
+  } Data;
+} REPLY_0547_t;
+
+typedef struct {
+  Header_t Header;
+  uint32_t StartF;
+  uint32_t Step;
+  uint16_t Count; // 0 and no list: cancel running batch
+  uint16_t SettleUs;
+  uint8_t Bw;        // PROBE_KEEP or BK4819_FilterBandwidth_t
+  uint8_t GainIndex; // PROBE_KEEP or gainTable index
+  bool bPrecise;
+  uint8_t ListSize; // frequencies following, replaces range
+  uint32_t List[0];
+} CMD_0548_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint8_t Status; // ProbeStatus
+    uint8_t Padding;
+    uint16_t Count;
+  } Data;
+} REPLY_0549_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint16_t Index; // of first record in batch
+    uint8_t Count;
+    bool bLast;
+    uint32_t ElapsedMs;
+    ProbeRecord Records[PROBE_FRAME_RECORDS];
+  } Data;
+} REPLY_054A_t;
+
+typedef struct {
+  Header_t Header;
+  bool bReset;     // after sending
+  bool bBenchmark; // also run SP_Benchmark (DEBUG builds), takes a while
+  uint8_t Padding[2];
+} CMD_054B_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint8_t Span; // LatSpan
+    uint8_t Spans;
+    uint8_t Buckets;
+    uint8_t Padding;
+    uint32_t Count;
+    uint32_t MaxUs;
+    uint32_t EdgesUs[LAT_BUCKETS - 1];
+    uint16_t Hist[LAT_BUCKETS];
+  } Data;
+} REPLY_054C_t;
+
 typedef struct {
   Header_t Header;
   uint8_t RegNum;
@@ -233,31 +449,58 @@ static bool bIsEncrypted = true;
 
 static Header_t Header;
 static Footer_t Footer;
-static uint8_t *pBytes;
-static void SendReply(void *pReply, uint16_t Size) {
+
+static void PrepareReply(void *pReply, uint16_t Size, Header_t *pHeader,
+                         Footer_t *pFooter) {
   uint16_t i;
 
   if (bIsEncrypted) {
-    pBytes = (uint8_t *)pReply;
+    uint8_t *pBytes = (uint8_t *)pReply;
     for (i = 0; i < Size; i++) {
       pBytes[i] ^= Obfuscation[i % 16];
     }
   }
 
-  Header.ID = 0xCDAB;
-  Header.Size = Size;
-  UART_Send(&Header, sizeof(Header));
-  UART_Send(pReply, Size);
+  pHeader->ID = 0xCDAB;
+  pHeader->Size = Size;
   if (bIsEncrypted) {
-    Footer.Padding[0] = Obfuscation[(Size + 0) % 16] ^ 0xFF;
-    Footer.Padding[1] = Obfuscation[(Size + 1) % 16] ^ 0xFF;
+    pFooter->Padding[0] = Obfuscation[(Size + 0) % 16] ^ 0xFF;
+    pFooter->Padding[1] = Obfuscation[(Size + 1) % 16] ^ 0xFF;
   } else {
-    Footer.Padding[0] = 0xFF;
-    Footer.Padding[1] = 0xFF;
+    pFooter->Padding[0] = 0xFF;
+    pFooter->Padding[1] = 0xFF;
+  }
+  pFooter->ID = 0xBADC;
+}
+
+static void SendReply(void *pReply, uint16_t Size) {
+  const bool locked = txLock();
+  txDrain(true);
+  PrepareReply(pReply, Size, &Header, &Footer);
+  sendRaw(&Header, sizeof(Header));
+  sendRaw(pReply, Size);
+  sendRaw(&Footer, sizeof(Footer));
+  txUnlock(locked);
+}
+
+// whole frame goes to TX queue or is dropped, never blocks
+static bool QueueReply(void *pReply, uint16_t Size) {
+  Header_t QHeader;
+  Footer_t QFooter;
+
+  // app update and render tasks both produce frames
+  vTaskSuspendAll();
+  const bool fits = txFree() >= sizeof(QHeader) + Size + sizeof(QFooter);
+  if (fits) {
+    PrepareReply(pReply, Size, &QHeader, &QFooter);
+    txPush(&QHeader, sizeof(QHeader));
+    txPush(pReply, Size);
+    txPush(&QFooter, sizeof(QFooter));
   }
-  Footer.ID = 0xBADC;
+  xTaskResumeAll();
 
-  UART_Send(&Footer, sizeof(Footer));
+  UART_TxPump();
+  return fits;
 }
 
 static void SendVersion(void) {
@@ -305,6 +548,9 @@ static void CMD_051B(const uint8_t *pBuffer) {
   Reply.Data.Offset = pCmd->Offset;
   Reply.Data.Size = pCmd->Size;
 
+  // newest data may still sit in ring, host reads home locations
+  NVRING_Sync();
+
   EEPROM_ReadBuffer(pCmd->Offset, Reply.Data.Data, pCmd->Size);
 
   SendReply(&Reply, pCmd->Size + 8 + 4);
@@ -322,6 +568,9 @@ static void CMD_051D(const uint8_t *pBuffer) {
   Reply.Header.Size = sizeof(Reply.Data);
   Reply.Data.Offset = pCmd->Offset;
 
+  // host writes home locations, ring copies must not shadow them
+  NVRING_Sync();
+
   uint16_t i;
 
   for (i = 0; i < (pCmd->Size / 8U); i++) {
@@ -348,6 +597,296 @@ static void CMD_0527(void) {
   SendReply(&Reply, sizeof(Reply));
 }
 
+// EEPROM wear: per-slot ring writes since boot
+static void CMD_0540(void) {
+  REPLY_0541_t Reply;
+  const NvRingStats *stats = NVRING_GetStats();
+
+  Reply.Header.ID = 0x0541;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Seq = stats->seq;
+  Reply.Data.Evictions = stats->evictions;
+  Reply.Data.Live = stats->live;
+  Reply.Data.Slots = NVRING_IsAvailable() ? NVRING_SLOTS : 0;
+  memcpy(Reply.Data.Writes, stats->writes, sizeof(Reply.Data.Writes));
+
+  NVRING_LogStats();
+  SendReply(&Reply, sizeof(Reply));
+}
+
+static bool bSpectrumStream;
+static uint16_t spectrumSeq;
+static uint32_t spectrumFrames;
+static uint32_t spectrumDropped;
+static uint16_t spectrumMaxCost;
+static REPLY_0544_t spectrumFrame; // appU stack is too small for it
+
+bool UART_IsSpectrumStreaming(void) { return bSpectrumStream; }
+
+void UART_SendSpectrum(uint32_t fs, uint32_t fe, uint32_t step,
+                       const uint16_t *rssi, uint8_t n) {
+  const TickType_t t = xTaskGetTickCount();
+  REPLY_0544_t *Reply = &spectrumFrame;
+
+  if (n > ARRAY_SIZE(Reply->Data.Rssi)) {
+    n = ARRAY_SIZE(Reply->Data.Rssi);
+  }
+
+  Reply->Header.ID = 0x0544;
+  Reply->Header.Size = sizeof(Reply->Data);
+  Reply->Data.Timestamp = Now();
+  Reply->Data.StartF = fs;
+  Reply->Data.EndF = fe;
+  Reply->Data.Step = step;
+  Reply->Data.Seq = spectrumSeq++;
+  Reply->Data.Count = n;
+  for (uint8_t i = 0; i < ARRAY_SIZE(Reply->Data.Rssi); ++i) {
+    const uint16_t v = i < n ? rssi[i] >> 1 : 0;
+    Reply->Data.Rssi[i] = v > UINT8_MAX ? UINT8_MAX : v;
+  }
+
+  if (QueueReply(Reply, sizeof(*Reply))) {
+    spectrumFrames++;
+  } else {
+    spectrumDropped++;
+  }
+
+  const TickType_t cost = xTaskGetTickCount() - t;
+  if (cost > spectrumMaxCost) {
+    spectrumMaxCost = cost;
+  }
+}
+
+// spectrum streaming on/off, replies with stream stats
+static void CMD_0542(const uint8_t *pBuffer) {
+  const CMD_0542_t *pCmd = (const CMD_0542_t *)pBuffer;
+  REPLY_0543_t Reply;
+
+  if (pCmd->bEnable && !bSpectrumStream) {
+    spectrumFrames = 0;
+    spectrumDropped = 0;
+    spectrumMaxCost = 0;
+  }
+  bSpectrumStream = pCmd->bEnable;
+
+  Reply.Header.ID = 0x0543;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.bEnabled = bSpectrumStream;
+  Reply.Data.MaxCostTicks = spectrumMaxCost;
+  Reply.Data.Frames = spectrumFrames;
+  Reply.Data.Dropped = spectrumDropped;
+
+  Log("SP stream=%u frames=%u dropped=%u max=%u", bSpectrumStream,
+      spectrumFrames, spectrumDropped, spectrumMaxCost);
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// Screen mirror: after each blit, changed pages are RLE-packed (or sent raw
+// when that is shorter) to TX queue. Page change is detected by hash, so no
+// copy of last sent frame is kept.
+#define SCREEN_INTERVAL_MS 200
+
+enum {
+  SCREEN_RAW,
+  SCREEN_RLE, // (count, value) pairs
+};
+
+static bool bScreenMirror;
+static uint16_t screenInterval = SCREEN_INTERVAL_MS;
+static uint32_t screenNextAt;
+static uint16_t screenSeq;
+static uint32_t screenHash[ARRAY_SIZE(gFrameBuffer)];
+static uint32_t screenFrames;
+static uint32_t screenPages;
+static uint32_t screenBytes;
+static uint32_t screenDeferred;
+static REPLY_0547_t screenPage;
+
+static uint32_t pageHash(const uint8_t *p) {
+  uint32_t h = 2166136261U;
+  for (uint8_t i = 0; i < LCD_WIDTH; ++i) {
+    h = (h ^ p[i]) * 16777619U;
+  }
+  return h;
+}
+
+// returns packed length, 0 when it would not be shorter than raw page
+static uint8_t rlePack(const uint8_t *p, uint8_t *out) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < LCD_WIDTH;) {
+    uint8_t run = 1;
+    while (i + run < LCD_WIDTH && p[i + run] == p[i]) {
+      run++;
+    }
+    if (n + 2 >= LCD_WIDTH) {
+      return 0;
+    }
+    out[n++] = run;
+    out[n++] = p[i];
+    i += run;
+  }
+  return n;
+}
+
+void UART_MirrorScreen(void) {
+  if (!bScreenMirror || Now() < screenNextAt) {
+    return;
+  }
+  screenNextAt = Now() + screenInterval;
+
+  REPLY_0547_t *Reply = &screenPage;
+  bool sent = false;
+
+  for (uint8_t page = 0; page < ARRAY_SIZE(gFrameBuffer); ++page) {
+    const uint32_t h = pageHash(gFrameBuffer[page]);
+    if (h == screenHash[page]) {
+      continue;
+    }
+
+    uint8_t len = rlePack(gFrameBuffer[page], Reply->Data.Bytes);
+    Reply->Data.Encoding = len ? SCREEN_RLE : SCREEN_RAW;
+    if (!len) {
+      len = LCD_WIDTH;
+      memcpy(Reply->Data.Bytes, gFrameBuffer[page], len);
+    }
+    Reply->Header.ID = 0x0547;
+    Reply->Header.Size = sizeof(Reply->Data) - LCD_WIDTH + len;
+    Reply->Data.Seq = screenSeq;
+    Reply->Data.Page = page;
+    Reply->Data.Len = len;
+
+    // queue full: page stays unsent and goes out with next frame
+    if (!QueueReply(Reply, sizeof(Reply->Header) + Reply->Header.Size)) {
+      screenDeferred++;
+      break;
+    }
+    screenHash[page] = h;
+    screenPages++;
+    screenBytes += len;
+    sent = true;
+  }
+
+  if (sent) {
+    screenSeq++;
+    screenFrames++;
+  }
+}
+
+static REPLY_054A_t probeFrame;
+
+bool UART_SendProbeRecords(uint16_t index, const ProbeRecord *records,
+                           uint8_t n, bool last, uint32_t elapsedMs) {
+  REPLY_054A_t *Reply = &probeFrame;
+
+  Reply->Header.ID = 0x054A;
+  Reply->Header.Size =
+      sizeof(Reply->Data) - sizeof(Reply->Data.Records) + n * sizeof(*records);
+  Reply->Data.Index = index;
+  Reply->Data.Count = n;
+  Reply->Data.bLast = last;
+  Reply->Data.ElapsedMs = elapsedMs;
+  memcpy(Reply->Data.Records, records, n * sizeof(*records));
+
+  return QueueReply(Reply, sizeof(Reply->Header) + Reply->Header.Size);
+}
+
+// batch measurement: range or list of frequencies, records come in 0x054A
+static void CMD_0548(const uint8_t *pBuffer) {
+  const CMD_0548_t *pCmd = (const CMD_0548_t *)pBuffer;
+  REPLY_0549_t Reply;
+
+  Reply.Header.ID = 0x0549;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Count = pCmd->ListSize ? pCmd->ListSize : pCmd->Count;
+
+  // list must be in packet, not stale bytes of a previous command
+  const uint16_t need = offsetof(CMD_0548_t, List) - sizeof(Header_t) +
+                        pCmd->ListSize * sizeof(pCmd->List[0]);
+  if (pCmd->Header.Size < need) {
+    Reply.Data.Status = PROBE_BAD_ARGS;
+  } else if (!Reply.Data.Count) {
+    PROBE_Cancel();
+    Reply.Data.Status = PROBE_OK;
+  } else {
+    const ProbeJob job = {
+        .startF = pCmd->StartF,
+        .step = pCmd->Step,
+        .count = pCmd->Count,
+        .settleUs = pCmd->SettleUs,
+        .bw = pCmd->Bw,
+        .gainIndex = pCmd->GainIndex,
+        .precise = pCmd->bPrecise,
+    };
+    Reply.Data.Status = PROBE_Start(&job, pCmd->List, pCmd->ListSize);
+  }
+
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// latency histograms, one 0x054C per span
+static void CMD_054B(const uint8_t *pBuffer) {
+  const CMD_054B_t *pCmd = (const CMD_054B_t *)pBuffer;
+  REPLY_054C_t Reply;
+
+  Reply.Header.ID = 0x054C;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Spans = LAT_COUNT;
+  Reply.Data.Buckets = LAT_BUCKETS;
+  memcpy(Reply.Data.EdgesUs, LAT_EDGES_US, sizeof(Reply.Data.EdgesUs));
+
+  for (uint8_t i = 0; i < LAT_COUNT; ++i) {
+    const LatHist *h = LAT_Get(i);
+    Reply.Data.Span = i;
+    Reply.Data.Count = h->count;
+    Reply.Data.MaxUs = h->maxUs;
+    memcpy(Reply.Data.Hist, h->hist, sizeof(Reply.Data.Hist));
+    SendReply(&Reply, sizeof(Reply));
+  }
+
+  if (pCmd->bReset) {
+    LAT_Reset();
+  }
+#ifdef DEBUG
+  if (pCmd->bBenchmark) {
+    SP_Benchmark();
+  }
+#endif
+}
+
+// screen mirroring on/off, replies with mirror stats
+static void CMD_0545(const uint8_t *pBuffer) {
+  const CMD_0545_t *pCmd = (const CMD_0545_t *)pBuffer;
+  REPLY_0546_t Reply;
+
+  if (pCmd->bEnable) {
+    // host (re)connects: send every page again
+    memset(screenHash, 0, sizeof(screenHash));
+    if (!bScreenMirror) {
+      screenFrames = 0;
+      screenPages = 0;
+      screenBytes = 0;
+      screenDeferred = 0;
+    }
+    screenInterval =
+        pCmd->IntervalMs ? pCmd->IntervalMs : SCREEN_INTERVAL_MS;
+    screenNextAt = 0;
+  }
+  bScreenMirror = pCmd->bEnable;
+
+  Reply.Header.ID = 0x0546;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.bEnabled = bScreenMirror;
+  Reply.Data.IntervalMs = screenInterval;
+  Reply.Data.Frames = screenFrames;
+  Reply.Data.Pages = screenPages;
+  Reply.Data.Bytes = screenBytes;
+  Reply.Data.Deferred = screenDeferred;
+
+  Log("SCR mirror=%u frames=%u pages=%u bytes=%u deferred=%u", bScreenMirror,
+      screenFrames, screenPages, screenBytes, screenDeferred);
+  SendReply(&Reply, sizeof(Reply));
+}
+
 static void CMD_052D(const uint8_t *pBuffer) {
   REPLY_052D_t Reply;
 
@@ -508,6 +1047,26 @@ void UART_HandleCommand(void) {
     CMD_052F(UART_Command.Buffer);
     break;
 
+  case 0x0540:
+    CMD_0540();
+    break;
+
+  case 0x0542:
+    CMD_0542(UART_Command.Buffer);
+    break;
+
+  case 0x0545:
+    CMD_0545(UART_Command.Buffer);
+    break;
+
+  case 0x0548:
+    CMD_0548(UART_Command.Buffer);
+    break;
+
+  case 0x054B:
+    CMD_054B(UART_Command.Buffer);
+    break;
+
   case 0x05DD:
     NVIC_SystemReset();
     break;
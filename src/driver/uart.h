@@ -2,12 +2,21 @@
 #define DRIVER_UART_H
 
 #include "../helper/channels.h"
+#include "../helper/probe.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 void UART_Init(void);
 void UART_Send(const void *pBuffer, uint32_t Size);
 void UART_printf(const char *str, ...);
+void UART_TxPump(void);
+
+bool UART_IsSpectrumStreaming(void);
+void UART_SendSpectrum(uint32_t fs, uint32_t fe, uint32_t step,
+                       const uint16_t *rssi, uint8_t n);
+void UART_MirrorScreen(void);
+bool UART_SendProbeRecords(uint16_t index, const ProbeRecord *records,
+                           uint8_t n, bool last, uint32_t elapsedMs);
 
 bool UART_IsCommandAvailable(void);
 void UART_HandleCommand(void);
@@ -171,13 +171,11 @@ void BANDS_SetRadioParamsFromCurrentBand() {
 void BANDS_Select(int16_t num, bool copyToVfo) {
   CHANNELS_Load(num, &gCurrentBand);
   // Log("Load Band %s", gCurrentBand.name);
-  for (int16_t i = 0; i < gScanlistSize; ++i) {
-    if (gScanlist[i] == num) {
-      scanlistBandIndex = i;
-      allBandIndex = bandIndexByFreq(gCurrentBand.rxF, true);
-      // Log("SL band index %u", i);
-      break;
-    }
+  const int16_t i = CHANNELS_ScanlistIndexOf(num);
+  if (i >= 0) {
+    scanlistBandIndex = i;
+    allBandIndex = bandIndexByFreq(gCurrentBand.rxF, true);
+    // Log("SL band index %u", i);
   }
   radio->allowTx = gCurrentBand.allowTx;
   if (copyToVfo) {
@@ -188,9 +186,10 @@ void BANDS_Select(int16_t num, bool copyToVfo) {
 
 // Used in vfo1 to select first band from scanlist
 void BANDS_SelectScan(int8_t i) {
-  if (gScanlistSize) {
+  const uint16_t mr = CHANNELS_ScanlistAt(i);
+  if (mr < SCANLIST_MAX) {
     scanlistBandIndex = i;
-    RADIO_TuneToBand(gScanlist[i]);
+    RADIO_TuneToBand(mr);
   }
 }
 
@@ -230,13 +229,17 @@ bool BANDS_SelectBandRelativeByScanlist(bool next) {
   }
   uint8_t oldScanlistBandIndex = scanlistBandIndex;
   scanlistBandIndex = IncDecU(scanlistBandIndex, 0, gScanlistSize, next);
-  BANDS_Select(gScanlist[scanlistBandIndex], true);
+  const uint16_t mr = CHANNELS_ScanlistAt(scanlistBandIndex);
+  if (mr >= SCANLIST_MAX) {
+    return false; // index left over from longer list
+  }
+  BANDS_Select(mr, true);
   return oldScanlistBandIndex != scanlistBandIndex;
 }
 
 void BANDS_SaveCurrent(void) {
   if (allBandIndex >= 0 && gCurrentBand.meta.type == TYPE_BAND) {
-    CHANNELS_Save(allBands[allBandIndex].mr, &gCurrentBand);
+    CHANNELS_SaveHot(allBands[allBandIndex].mr, &gCurrentBand);
   }
 }
 
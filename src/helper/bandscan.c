@@ -0,0 +1,142 @@
+#include "bandscan.h"
+#include "../driver/uart.h"
+#include "../radio.h"
+#include "../scheduler.h"
+#include "../settings.h"
+#include "bands.h"
+#include <string.h>
+
+// Round-robin over TYPE_BAND entries of current scanlist.
+// Slice length grows with recent activity, activity halves every full round.
+
+static ScanBand bands[BANDSCAN_MAX];
+static uint8_t size;
+static uint8_t current;
+static uint32_t sliceStart;
+static uint32_t sliceMs;
+
+static uint32_t sliceFor(const ScanBand *sb) {
+  return BANDSCAN_SLICE_MS * (1 + sb->activity);
+}
+
+// walks channel slots itself, so the user's loaded scanlist stays as is
+uint8_t BANDSCAN_Load(void) {
+  const uint32_t bound = SETTINGS_GetFilterBound();
+  const uint16_t mask = gSettings.currentScanlist;
+  size = 0;
+  current = 0;
+
+  for (uint16_t mr = 0; mr < CHANNELS_GetCountMax() && size < BANDSCAN_MAX;
+       ++mr) {
+    if (CHANNELS_GetMeta(mr).type != TYPE_BAND ||
+        (mask != SCANLIST_ALL && !(CHANNELS_Scanlists(mr) & mask))) {
+      continue;
+    }
+    Band b;
+    CHANNELS_Load(mr, &b);
+    const uint32_t s = b.rxF;
+    const uint32_t e = b.txF;
+    if (s >= e) {
+      continue;
+    }
+    ScanBand *sb = &bands[size++];
+    *sb = (ScanBand){
+        .s = s,
+        .e = e,
+        .mr = mr,
+        .step = b.step,
+        .modulation = b.modulation,
+        .bw = b.bw,
+        .gainIndex = b.gainIndex,
+        .ppm = b.ppm,
+        .squelch = b.squelch,
+        .filter = s + (e - s) / 2 < bound ? FILTER_VHF : FILTER_UHF,
+    };
+    memcpy(sb->name, b.name, sizeof(sb->name));
+  }
+
+  Log("BANDSCAN loaded %u bands", size);
+
+  sliceStart = Now();
+  sliceMs = size ? sliceFor(&bands[0]) : 0;
+  return size;
+}
+
+uint8_t BANDSCAN_Size(void) { return size; }
+
+ScanBand *BANDSCAN_Current(void) { return size ? &bands[current] : NULL; }
+
+ScanBand *BANDSCAN_Item(uint8_t i) { return i < size ? &bands[i] : NULL; }
+
+// from params taken at load, no EEPROM read on band switch
+void BANDSCAN_Apply(void) {
+  const ScanBand *sb = &bands[current];
+
+  gCurrentBand = (Band){
+      .meta.type = TYPE_BAND,
+      .rxF = sb->s,
+      .txF = sb->e,
+      .ppm = sb->ppm,
+      .step = sb->step,
+      .modulation = sb->modulation,
+      .bw = sb->bw,
+      .gainIndex = sb->gainIndex,
+      .squelch = sb->squelch,
+  };
+  memcpy(gCurrentBand.name, sb->name, sizeof(gCurrentBand.name));
+
+  radio->rxF = sb->s;
+  BANDS_SetRadioParamsFromCurrentBand();
+  RADIO_Setup();
+}
+
+// returns true when switched to another band, caller applies it
+bool BANDSCAN_Update(void) {
+  if (!size) {
+    return false;
+  }
+
+  uint32_t elapsed = Now() - sliceStart;
+  if (elapsed < sliceMs) {
+    return false;
+  }
+
+  bands[current].dwellMs += elapsed;
+
+  if (size == 1) {
+    sliceStart = Now();
+    return false;
+  }
+
+  current++;
+  if (current >= size) {
+    current = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+      bands[i].activity >>= 1;
+    }
+  }
+
+  sliceStart = Now();
+  sliceMs = sliceFor(&bands[current]);
+  return true;
+}
+
+void BANDSCAN_Hit(void) {
+  if (!size) {
+    return;
+  }
+  ScanBand *sb = &bands[current];
+  if (sb->activity < BANDSCAN_ACTIVITY_MAX) {
+    sb->activity++;
+  }
+  // let the active band keep the radio longer right away
+  sliceMs = sliceFor(sb);
+}
+
+uint32_t BANDSCAN_TotalDwell(void) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < size; ++i) {
+    total += bands[i].dwellMs;
+  }
+  return total;
+}
@@ -0,0 +1,37 @@
+#ifndef BANDSCAN_H
+#define BANDSCAN_H
+
+#include "channels.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BANDSCAN_MAX 16
+#define BANDSCAN_SLICE_MS 2000
+#define BANDSCAN_ACTIVITY_MAX 7
+
+typedef struct {
+  uint32_t s;
+  uint32_t e;
+  uint32_t dwellMs;
+  uint16_t mr;
+  Step step : 4;
+  ModulationType modulation : 4;
+  BK4819_FilterBandwidth_t bw : 4;
+  uint8_t gainIndex : 5;
+  uint8_t activity : 3;
+  int8_t ppm : 5;
+  Squelch squelch;
+  Filter filter;
+  char name[10];
+} ScanBand;
+
+uint8_t BANDSCAN_Load(void);
+uint8_t BANDSCAN_Size(void);
+ScanBand *BANDSCAN_Current(void);
+ScanBand *BANDSCAN_Item(uint8_t i);
+bool BANDSCAN_Update(void);
+void BANDSCAN_Apply(void);
+void BANDSCAN_Hit(void);
+uint32_t BANDSCAN_TotalDwell(void);
+
+#endif /* end of include guard: BANDSCAN_H */
@@ -1,16 +1,30 @@
 #include "battery.h"
 #include "../board.h"
+#include "../driver/adc.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/timers.h"
 #include "../misc.h"
 #include "../settings.h"
 
+// Conversion is started from timer and collected on next tick, so no task
+// waits on SARADC. Readers use globals below, each written in one store.
+#define BATTERY_SAMPLES 8 // power of 2
+#define BATTERY_SAMPLE_MS 100
+
 uint16_t gBatteryVoltage = 0;
 uint16_t gBatteryCurrent = 0;
 uint8_t gBatteryPercent = 0;
 bool gChargingWithTypeC = true;
 
-static uint16_t batAdcV = 0;
 static uint16_t batAvgV = 0;
 
+static uint16_t samples[BATTERY_SAMPLES];
+static uint16_t samplesSum;
+static uint8_t sampleIndex;
+
+static StaticTimer_t sampleTimerBuffer;
+static TimerHandle_t sampleTimer;
+
 const char *BATTERY_TYPE_NAMES[3] = {"1600mAh", "2200mAh", "3500mAh"};
 const char *BATTERY_STYLE_NAMES[3] = {"Icon", "%", "V"};
 
@@ -88,18 +102,53 @@ uint8_t BATTERY_VoltsToPercent(const unsigned int voltage_10mV) {
   return 0;
 }
 
-void BATTERY_UpdateBatteryInfo() {
-  BOARD_ADC_GetBatteryInfo(&batAdcV, &gBatteryCurrent);
-  bool charg = gBatteryCurrent >= 501;
+static void addSample(uint16_t adcV, uint16_t current) {
+  const bool charg = current >= 501;
   if (batAvgV == 0 || charg != gChargingWithTypeC) {
-    batAvgV = batAdcV;
+    for (uint8_t i = 0; i < BATTERY_SAMPLES; ++i) {
+      samples[i] = adcV;
+    }
+    samplesSum = adcV * BATTERY_SAMPLES;
   } else {
-    batAvgV = batAvgV - (batAvgV - batAdcV) / 7;
+    samplesSum += adcV - samples[sampleIndex];
+    samples[sampleIndex] = adcV;
+    sampleIndex = (sampleIndex + 1) % BATTERY_SAMPLES;
   }
+  batAvgV = samplesSum / BATTERY_SAMPLES;
 
-  gBatteryVoltage = (batAvgV * 760) / gSettings.batteryCalibration;
+  gBatteryCurrent = current;
   gChargingWithTypeC = charg;
-  gBatteryPercent = BATTERY_VoltsToPercent(gBatteryVoltage);
+  if (gSettings.batteryCalibration) {
+    gBatteryVoltage = (batAvgV * 760) / gSettings.batteryCalibration;
+    gBatteryPercent = BATTERY_VoltsToPercent(gBatteryVoltage);
+  }
+}
+
+static void sampleTimerCallback(TimerHandle_t t) {
+  if (ADC_CheckEndOfConversion(ADC_CH9)) {
+    const uint16_t adcV = ADC_GetValue(ADC_CH4);
+    addSample(adcV, ADC_GetValue(ADC_CH9));
+  }
+  ADC_Start();
+}
+
+// blocking conversion, only before sampling timer runs
+void BATTERY_UpdateBatteryInfo() {
+  uint16_t adcV, current;
+  BOARD_ADC_GetBatteryInfo(&adcV, &current);
+  addSample(adcV, current);
+}
+
+void BATTERY_Init(void) {
+  if (sampleTimer) {
+    return;
+  }
+  BATTERY_UpdateBatteryInfo();
+  sampleTimer = xTimerCreateStatic("BAT", pdMS_TO_TICKS(BATTERY_SAMPLE_MS),
+                                   pdTRUE, NULL, sampleTimerCallback,
+                                   &sampleTimerBuffer);
+  ADC_Start();
+  xTimerStart(sampleTimer, 0);
 }
 
 uint32_t BATTERY_GetPreciseVoltage(uint16_t cal) {
@@ -0,0 +1,52 @@
+#include "bitrank.h"
+
+static uint8_t popcount(uint32_t v) {
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+  v = (v + (v >> 4)) & 0x0F0F0F0F;
+  return (v * 0x01010101) >> 24;
+}
+
+// returns total set bits
+uint16_t BITRANK_Build(const uint32_t *bits, uint16_t *rank, uint8_t words) {
+  uint16_t n = 0;
+  for (uint8_t w = 0; w < words; ++w) {
+    rank[w] = n;
+    n += popcount(bits[w]);
+  }
+  return n;
+}
+
+uint16_t BITRANK_Select(const uint32_t *bits, const uint16_t *rank,
+                        uint8_t words, uint16_t index) {
+  if (!words || index >= rank[words - 1] + popcount(bits[words - 1])) {
+    return words * 32;
+  }
+  uint8_t w = words - 1;
+  while (w && rank[w] > index) {
+    w--;
+  }
+  uint32_t b = bits[w];
+  for (uint16_t k = index - rank[w]; k; --k) {
+    b &= b - 1;
+  }
+  uint8_t bit = 0;
+  while (!(b & 1)) {
+    b >>= 1;
+    bit++;
+  }
+  return w * 32 + bit;
+}
+
+int16_t BITRANK_Rank(const uint32_t *bits, const uint16_t *rank, uint8_t words,
+                     uint16_t pos) {
+  if (pos >= words * 32) {
+    return -1;
+  }
+  const uint8_t w = pos / 32;
+  const uint32_t mask = 1UL << (pos % 32);
+  if (!(bits[w] & mask)) {
+    return -1;
+  }
+  return rank[w] + popcount(bits[w] & (mask - 1));
+}
@@ -0,0 +1,17 @@
+#ifndef BITRANK_H
+#define BITRANK_H
+
+#include <stdint.h>
+
+// Rank/select over a bitset of 32-bit words. rank[w] holds set bits in words
+// before w, filled by BITRANK_Build. No firmware deps, host tests build it.
+
+uint16_t BITRANK_Build(const uint32_t *bits, uint16_t *rank, uint8_t words);
+// position of index-th set bit, words * 32 when index is out of range
+uint16_t BITRANK_Select(const uint32_t *bits, const uint16_t *rank,
+                        uint8_t words, uint16_t index);
+// set bits before pos, -1 when bit at pos is clear
+int16_t BITRANK_Rank(const uint32_t *bits, const uint16_t *rank, uint8_t words,
+                     uint16_t pos);
+
+#endif /* end of include guard: BITRANK_H */
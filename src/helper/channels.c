@@ -1,14 +1,22 @@
 #include "channels.h"
 #include "../driver/eeprom.h"
 #include "../driver/uart.h"
+#include "../helper/bitrank.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
+#include "../helper/nvring.h"
 #include "../radio.h"
 #include <stddef.h>
 #include <string.h>
 
+#define SL_WORDS (SCANLIST_MAX / 32)
+
+// Scanlist as bitset over channel slots, ascending channel order.
+// slRank[w] = set bits in words before w, for rank/select in O(words).
 int16_t gScanlistSize = 0;
-uint16_t gScanlist[SCANLIST_MAX] = {0};
+uint16_t gChannelsRevision = 0; // bumped on any channel or scanlist change
+static uint32_t slBits[SL_WORDS];
+static uint16_t slRank[SL_WORDS];
 CHType gScanlistType = TYPE_CH;
 const char *CH_TYPE_NAMES[6] = {"EMPTY", "CH",     "BAND",
                                 "VFO",   "FOLDER", "MELODY"};
@@ -34,8 +42,14 @@ uint16_t CHANNELS_GetCountMax(void) {
   return n < SCANLIST_MAX ? n : SCANLIST_MAX;
 }
 
+// space left between last channel slot and patch (large EEPROMs only)
+void CHANNELS_GetFreeArea(uint32_t *start, uint32_t *end) {
+  *start = GetChannelOffset(CHANNELS_GetCountMax());
+  *end = getChannelsEnd();
+}
+
 void CHANNELS_Load(int16_t num, CH *p) {
-  if (num >= 0) {
+  if (num >= 0 && !NVRING_Read(num, 0, p, CH_SIZE)) {
     EEPROM_ReadBuffer(GetChannelOffset(num), p, CH_SIZE);
     /* Log(">> R CH%u '%s': f=%u, radio=%u, type=%s", num, p->name, p->rxF,
         p->radio, CH_TYPE_NAMES[p->meta.type]); */
@@ -46,6 +60,36 @@ void CHANNELS_Save(int16_t num, CH *p) {
   if (num >= 0) {
     /* Log(">> W CH%u OFS=%u '%s': f=%u, radio=%u", num, GetChannelOffset(num),
         p->name, p->rxF, p->radio); */
+    gChannelsRevision++;
+    // newest copy is in ring, keep it there
+    if (NVRING_Has(num) && NVRING_Write(num, p, CH_SIZE)) {
+      return;
+    }
+    EEPROM_WriteBuffer(GetChannelOffset(num), p, CH_SIZE);
+  }
+}
+
+// Writes only [offset, offset + size) of record, so a single field edit
+// touches one page. Ring copies are always whole records.
+void CHANNELS_SaveField(int16_t num, CH *p, uint8_t offset, uint8_t size) {
+  if (num < 0 || offset + size > CH_SIZE) {
+    return;
+  }
+  gChannelsRevision++;
+  if (NVRING_Has(num) && NVRING_Write(num, p, CH_SIZE)) {
+    return;
+  }
+  EEPROM_WriteBuffer(GetChannelOffset(num) + offset, (uint8_t *)p + offset,
+                     size);
+}
+
+// for records rewritten on every knob turn (VFOs, current band)
+void CHANNELS_SaveHot(int16_t num, CH *p) {
+  if (num < 0) {
+    return;
+  }
+  gChannelsRevision++;
+  if (!NVRING_Write(num, p, CH_SIZE)) {
     EEPROM_WriteBuffer(GetChannelOffset(num), p, CH_SIZE);
   }
 }
@@ -72,15 +116,31 @@ bool CHANNELS_Existing_CH(int16_t num) {
 
 uint16_t CHANNELS_Scanlists(int16_t num) {
   uint16_t sl;
-  EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, scanlists), &sl, 2);
+  if (!NVRING_Read(num, offsetof(CH, scanlists), &sl, 2)) {
+    EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, scanlists), &sl, 2);
+  }
   return sl;
 }
+
+// channel number of index-th scanlist item, SCANLIST_MAX when out of range
+uint16_t CHANNELS_ScanlistAt(uint16_t index) {
+  return BITRANK_Select(slBits, slRank, SL_WORDS, index);
+}
+
+// index of channel in scanlist or -1
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num) {
+  return BITRANK_Rank(slBits, slRank, SL_WORDS, num);
+}
+
 static int16_t chScanlistIndex = 0;
 
 void CHANNELS_Next(bool next) {
   if (gScanlistSize) {
     chScanlistIndex = IncDecI(chScanlistIndex, 0, gScanlistSize, next);
-    int16_t chNum = gScanlist[chScanlistIndex];
+    const uint16_t chNum = CHANNELS_ScanlistAt(chScanlistIndex);
+    if (chNum >= SCANLIST_MAX) {
+      return;
+    }
     radio->channel = chNum;
     RADIO_VfoLoadCH(gSettings.activeVFO);
     RADIO_SetupByCurrentVFO();
@@ -94,6 +154,8 @@ void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
     SETTINGS_Save();
   }
   gScanlistSize = 0;
+  gChannelsRevision++;
+  memset(slBits, 0, sizeof(slBits));
   for (int16_t i = 0; i < CHANNELS_GetCountMax(); ++i) {
     CHMeta meta = CHANNELS_GetMeta(i);
     bool isSaveFilter = typeFilter == TYPE_FILTER_BAND_SAVE ||
@@ -110,11 +172,13 @@ void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
                          (CHANNELS_Scanlists(i) & scanlistMask) ||
                          isEmptyChannelToSave;
     if (isOurScanlist) {
-      gScanlist[gScanlistSize] = i;
+      slBits[i / 32] |= 1UL << (i % 32);
       gScanlistSize++;
       // Log("Load CH %u in SL", i);
     }
   }
+
+  BITRANK_Build(slBits, slRank, SL_WORDS);
   // Log("SL sz: %u", gScanlistSize);
 }
 
@@ -149,7 +213,9 @@ uint32_t CHANNELS_GetChannel(CH *p, uint32_t f) {
 
 CHMeta CHANNELS_GetMeta(int16_t num) {
   CHMeta meta;
-  EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, meta), &meta, 1);
+  if (!NVRING_Read(num, offsetof(CH, meta), &meta, 1)) {
+    EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, meta), &meta, 1);
+  }
   return meta;
 }
 
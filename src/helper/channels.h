@@ -152,9 +152,12 @@ typedef MR VFO;
 typedef MR CH;
 
 uint16_t CHANNELS_GetCountMax();
+void CHANNELS_GetFreeArea(uint32_t *start, uint32_t *end);
 
 void CHANNELS_Load(int16_t num, CH *p);
 void CHANNELS_Save(int16_t num, CH *p);
+void CHANNELS_SaveHot(int16_t num, CH *p);
+void CHANNELS_SaveField(int16_t num, CH *p, uint8_t offset, uint8_t size);
 bool CHANNELS_LoadBuf();
 void CHANNELS_Next(bool next);
 void CHANNELS_Delete(int16_t i);
@@ -174,8 +177,11 @@ bool CHANNELS_IsScanlistable(CHType type);
 bool CHANNELS_IsFreqable(CHType type);
 uint16_t CHANNELS_ScanlistByKey(uint16_t sl, KEY_Code_t key, bool longPress);
 
+uint16_t CHANNELS_ScanlistAt(uint16_t index);
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num);
+
 extern int16_t gScanlistSize;
-extern uint16_t gScanlist[SCANLIST_MAX];
+extern uint16_t gChannelsRevision;
 extern const char *TX_POWER_NAMES[4];
 extern const char *TX_OFFSET_NAMES[3];
 extern const char *TX_CODE_TYPES[4];
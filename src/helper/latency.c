@@ -0,0 +1,113 @@
+#include "latency.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include "../misc.h"
+#include "../scheduler.h"
+#include <string.h>
+
+// Fixed-bucket histograms of radio hot path timings in us. Points are marked
+// from app, service and render tasks, so state is touched in critical
+// sections only; timestamp is taken before entering one.
+// Only first RSSI/squelch open after tune counts, and audio only after
+// squelch opened, so polling the same channel adds nothing.
+
+#define STEP_MAX_US 1000000 // longer gaps are dwell, not scan steps
+
+enum {
+  PEND_RSSI = 1 << 0,
+  PEND_SQL = 1 << 1,
+  PEND_AUDIO = 1 << 2,
+  TUNED = 1 << 3,
+};
+
+const uint32_t LAT_EDGES_US[LAT_BUCKETS - 1] = {
+    50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000,
+};
+
+const char *LAT_NAMES[LAT_COUNT] = {
+    [LAT_TUNE_RSSI] = "Tune>RSSI",
+    [LAT_TUNE_SQL] = "Tune>SQL",
+    [LAT_SQL_AUDIO] = "SQL>Audio",
+    [LAT_STEP] = "Step",
+    [LAT_RENDER] = "Render",
+};
+
+static LatHist hists[LAT_COUNT];
+static uint32_t tuneUs;
+static uint32_t sqlUs;
+static uint8_t flags;
+
+static void add(LatSpan span, uint32_t us) {
+  LatHist *h = &hists[span];
+  uint8_t i = 0;
+  while (i < ARRAY_SIZE(LAT_EDGES_US) && us >= LAT_EDGES_US[i]) {
+    i++;
+  }
+  if (h->hist[i] < UINT16_MAX) {
+    h->hist[i]++;
+  }
+  h->count++;
+  if (us > h->maxUs) {
+    h->maxUs = us;
+  }
+}
+
+void LAT_Add(LatSpan span, uint32_t us) {
+  taskENTER_CRITICAL();
+  add(span, us);
+  taskEXIT_CRITICAL();
+}
+
+void LAT_Mark(LatPoint p) {
+  const uint32_t now = NowUs();
+
+  taskENTER_CRITICAL();
+  switch (p) {
+  case LAT_P_TUNE:
+    if ((flags & TUNED) && now - tuneUs < STEP_MAX_US) {
+      add(LAT_STEP, now - tuneUs);
+    }
+    tuneUs = now;
+    flags = TUNED | PEND_RSSI | PEND_SQL;
+    break;
+  case LAT_P_RSSI:
+    if (flags & PEND_RSSI) {
+      add(LAT_TUNE_RSSI, now - tuneUs);
+      flags &= ~PEND_RSSI;
+    }
+    break;
+  case LAT_P_SQL:
+    if (flags & PEND_SQL) {
+      add(LAT_TUNE_SQL, now - tuneUs);
+      flags &= ~PEND_SQL;
+    }
+    sqlUs = now;
+    flags |= PEND_AUDIO;
+    break;
+  case LAT_P_AUDIO:
+    if (flags & PEND_AUDIO) {
+      add(LAT_SQL_AUDIO, now - sqlUs);
+      flags &= ~PEND_AUDIO;
+    }
+    break;
+  }
+  taskEXIT_CRITICAL();
+}
+
+// for Measurement.timeUs, 0 before first tune
+uint16_t LAT_SinceTuneUs(void) {
+  if (!(flags & TUNED)) {
+    return 0;
+  }
+  const uint32_t us = NowUs() - tuneUs;
+  return us > UINT16_MAX ? UINT16_MAX : us;
+}
+
+const LatHist *LAT_Get(LatSpan span) { return &hists[span]; }
+
+void LAT_Reset(void) {
+  taskENTER_CRITICAL();
+  memset(hists, 0, sizeof(hists));
+  flags = 0;
+  taskEXIT_CRITICAL();
+}
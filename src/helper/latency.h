@@ -0,0 +1,40 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LAT_BUCKETS 12
+
+typedef enum {
+  LAT_P_TUNE,
+  LAT_P_RSSI, // first valid RSSI after tune
+  LAT_P_SQL,  // squelch open
+  LAT_P_AUDIO,
+} LatPoint;
+
+typedef enum {
+  LAT_TUNE_RSSI,
+  LAT_TUNE_SQL,
+  LAT_SQL_AUDIO,
+  LAT_STEP, // tune to next tune
+  LAT_RENDER,
+  LAT_COUNT,
+} LatSpan;
+
+typedef struct {
+  uint32_t count;
+  uint32_t maxUs;
+  uint16_t hist[LAT_BUCKETS]; // saturating
+} LatHist;
+
+extern const uint32_t LAT_EDGES_US[LAT_BUCKETS - 1];
+extern const char *LAT_NAMES[LAT_COUNT];
+
+void LAT_Mark(LatPoint p);
+void LAT_Add(LatSpan span, uint32_t us);
+uint16_t LAT_SinceTuneUs(void);
+const LatHist *LAT_Get(LatSpan span);
+void LAT_Reset(void);
+
+#endif /* end of include guard: LATENCY_H */
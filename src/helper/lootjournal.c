@@ -0,0 +1,253 @@
+#include "lootjournal.h"
+#include "../driver/eeprom.h"
+#include "../driver/uart.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include "../external/FreeRTOS/include/timers.h"
+#include "../scheduler.h"
+#include "../svc.h"
+#include "channels.h"
+#include "lootlist.h"
+#include "nvring.h"
+
+// Two halves in the free EEPROM space after channel slots. Records are only
+// appended to the active half. When it is full (or items were removed), a
+// snapshot of the whole list goes to the other half under next generation,
+// so both halves wear evenly. Snapshot header in record 0 is written after
+// all items, so half is taken at boot only once complete. Check byte is
+// salted with whole generation, and every write ends with a bad record, so
+// stale records after the tail are not replayed.
+
+typedef enum {
+  REC_ITEM = 1,
+  REC_HEADER = 2,
+} RecordKind;
+
+typedef struct {
+  uint32_t f : 27;
+  bool blacklist : 1;
+  bool whitelist : 1;
+  RecordKind kind : 3;
+  uint16_t duration;
+  uint8_t tone;
+  uint8_t check;
+} __attribute__((packed)) Record;
+
+#define REC_SIZE sizeof(Record)
+#define RECORDS_MAX (LOOTJOURNAL_HALF_SIZE / REC_SIZE)
+#define WBUF_RECORDS 8
+
+_Static_assert(sizeof(Record) == 8, "journal record size");
+_Static_assert(RECORDS_MAX > LOOT_SIZE_MAX, "snapshot must fit in half");
+
+static uint32_t base = 0; // 0: no room in this EEPROM
+static uint8_t half;
+static uint16_t gen;
+static uint16_t tail;
+static bool rebuild;
+
+static Record wbuf[WBUF_RECORDS + 1]; // + end marker
+static uint8_t wbufN;
+
+static StaticTimer_t flushTimerBuffer;
+static TimerHandle_t flushTimer;
+
+static uint8_t crc8(uint8_t crc, const uint8_t *p, uint8_t n) {
+  while (n--) {
+    crc ^= *p++;
+    for (uint8_t i = 0; i < 8; ++i) {
+      crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint8_t checkOf(const Record *r, uint16_t g) {
+  const uint8_t salt[2] = {g & 0xFF, g >> 8};
+  return crc8(crc8(0, salt, sizeof(salt)), (const uint8_t *)r, REC_SIZE - 1);
+}
+
+static uint32_t halfAddr(uint8_t h) {
+  return base + h * LOOTJOURNAL_HALF_SIZE;
+}
+
+static bool readHeader(uint8_t h, uint16_t *g) {
+  Record r;
+  EEPROM_ReadBuffer(halfAddr(h), &r, REC_SIZE);
+  *g = r.f;
+  return r.kind == REC_HEADER && r.check == checkOf(&r, *g);
+}
+
+// also with nothing buffered: empty snapshot still needs its end marker
+static void wbufFlush(void) {
+  uint8_t n = wbufN;
+  if (tail < RECORDS_MAX) {
+    Record *end = &wbuf[n++];
+    *end = (Record){0};
+    end->check = ~checkOf(end, gen);
+  }
+  EEPROM_WriteBuffer(halfAddr(half) + (tail - wbufN) * REC_SIZE, wbuf,
+                     n * REC_SIZE);
+  wbufN = 0;
+}
+
+static void append(Record *r) {
+  r->check = checkOf(r, gen);
+  wbuf[wbufN++] = *r;
+  tail++;
+  if (wbufN == WBUF_RECORDS) {
+    wbufFlush();
+  }
+}
+
+// copies item and clears its dirty flag atomically against unlocked field
+// edits by app; caller holds loot lock
+static Record takeItem(uint16_t i) {
+  taskENTER_CRITICAL();
+  Loot *item = LOOT_Item(i);
+  Record r = {
+      .f = item->f,
+      .blacklist = item->blacklist,
+      .whitelist = item->whitelist,
+      .kind = REC_ITEM,
+      .duration = item->duration,
+      .tone = item->tone,
+  };
+  item->dirty = false;
+  taskEXIT_CRITICAL();
+  return r;
+}
+
+static void compact(void) {
+  rebuild = false;
+  half = !half;
+  gen++;
+  tail = 1; // record 0 is header
+
+  // list must not change shape while snapshot is taken, so lock is held
+  // over page writes too; compaction is rare
+  LOOT_Lock();
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    Record r = takeItem(i);
+    append(&r);
+  }
+  wbufFlush();
+  LOOT_Unlock();
+
+  // commit point: until here boot picks the previous half
+  Record h = {.f = gen, .kind = REC_HEADER};
+  h.check = checkOf(&h, gen);
+  EEPROM_WriteBuffer(halfAddr(half), &h, REC_SIZE);
+  Log("LJ compact gen=%u n=%u", gen, tail - 1);
+}
+
+void LOOTJOURNAL_Flush(void) {
+  if (!base) {
+    return;
+  }
+  if (rebuild) {
+    compact();
+    return;
+  }
+
+  LOOT_Lock();
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    n += LOOT_Item(i)->dirty;
+  }
+  if (!n) {
+    LOOT_Unlock();
+    return;
+  }
+  if (tail + n > RECORDS_MAX) {
+    LOOT_Unlock();
+    compact();
+    return;
+  }
+
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    if (LOOT_Item(i)->dirty) {
+      Record r = takeItem(i);
+      append(&r);
+    }
+  }
+  wbufFlush();
+  LOOT_Unlock();
+  Log("LJ +%u tail=%u", n, tail);
+}
+
+void LOOTJOURNAL_Rebuild(void) { rebuild = true; }
+
+bool LOOTJOURNAL_IsAvailable(void) { return base != 0; }
+
+static void restore(void) {
+  Record buf[WBUF_RECORDS];
+  uint32_t addr = halfAddr(half);
+
+  tail = 0;
+  for (;;) {
+    EEPROM_ReadBuffer(addr, buf, sizeof(buf));
+    addr += sizeof(buf);
+    for (uint8_t i = 0; i < WBUF_RECORDS; ++i, ++tail) {
+      const Record *r = &buf[i];
+      if (tail == RECORDS_MAX || r->check != checkOf(r, gen)) {
+        return;
+      }
+      if (r->kind != REC_ITEM) {
+        continue;
+      }
+      Loot *item = LOOT_AddEx(r->f, true);
+      item->blacklist = r->blacklist;
+      item->whitelist = r->whitelist;
+      item->duration = r->duration;
+      item->tone = r->tone;
+      item->open = false;
+      item->lastTimeOpen = 0;
+      item->dirty = false;
+    }
+  }
+}
+
+// flush holds loot lock over page writes, so it runs in services task
+static void flushTimerCallback(TimerHandle_t t) {
+  SVC_Defer(LOOTJOURNAL_Flush);
+}
+
+void LOOTJOURNAL_Init(void) {
+  uint32_t start, end;
+  CHANNELS_GetFreeArea(&start, &end);
+  if (NVRING_IsAvailable()) {
+    end = NVRING_GetStart();
+  }
+  const uint16_t pageSize = SETTINGS_GetPageSize();
+  start = (start + pageSize - 1) / pageSize * pageSize;
+
+  if (start + LOOTJOURNAL_HALF_SIZE * 2 > end) {
+    Log("LJ no room");
+    return;
+  }
+  base = start;
+
+  const uint32_t t = Now();
+  uint16_t g0, g1;
+  bool ok0 = readHeader(0, &g0);
+  bool ok1 = readHeader(1, &g1);
+
+  if (ok0 || ok1) {
+    half = ok1 && (!ok0 || (int16_t)(g1 - g0) > 0);
+    gen = half ? g1 : g0;
+    restore();
+  } else {
+    // fresh region: start with empty snapshot in half 0
+    half = 1;
+    gen = 0;
+    compact();
+  }
+  Log("LJ @%u gen=%u tail=%u loot=%u %ums", base, gen, tail, LOOT_Size(),
+      Now() - t);
+
+  flushTimer =
+      xTimerCreateStatic("LJ", pdMS_TO_TICKS(LOOTJOURNAL_FLUSH_MS), pdTRUE,
+                         NULL, flushTimerCallback, &flushTimerBuffer);
+  xTimerStart(flushTimer, 0);
+}
@@ -0,0 +1,15 @@
+#ifndef LOOTJOURNAL_H
+#define LOOTJOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LOOTJOURNAL_HALF_SIZE 4096 // 512 records, snapshot of full list fits
+#define LOOTJOURNAL_FLUSH_MS (60 * 1000)
+
+void LOOTJOURNAL_Init(void);
+void LOOTJOURNAL_Flush(void);
+void LOOTJOURNAL_Rebuild(void);
+bool LOOTJOURNAL_IsAvailable(void);
+
+#endif /* end of include guard: LOOTJOURNAL_H */
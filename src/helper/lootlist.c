@@ -1,16 +1,33 @@
 #include "lootlist.h"
 #include "../dcs.h"
 #include "../driver/bk4819.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/semphr.h"
 #include "../external/printf/printf.h"
 #include "../radio.h"
 #include "../scheduler.h"
 #include "bands.h"
+#include "lootjournal.h"
 #include <stdint.h>
 
+_Static_assert(LOOT_TONE_DCS == ARRAY_SIZE(CTCSS_Options), "tone packing");
+_Static_assert(sizeof(Loot) == 9, "loot item size");
+
+// Radio services add and update items from their task while the loot list
+// app sorts and removes from appU, so every change of list shape is done
+// under the lock. Field edits of one item by app need no lock, as items
+// move only on sort/remove, which are app-side too.
+static StaticSemaphore_t mutexBuffer;
+static SemaphoreHandle_t mutex;
+
 static Loot loot[LOOT_SIZE_MAX] = {0};
 static uint32_t lastTimeCheck = 0;
 static int16_t lootIndex = -1;
 
+// sub-100ms part of open time, kept for the item being accumulated
+static const Loot *durationItem = NULL;
+static uint8_t durationRemMs = 0;
+
 Loot *gLastActiveLoot = NULL;
 int16_t gLastActiveLootIndex = -1;
 
@@ -18,6 +35,7 @@ void LOOT_BlacklistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->whitelist = false;
     gLastActiveLoot->blacklist = true;
+    gLastActiveLoot->dirty = true;
   }
 }
 
@@ -25,7 +43,62 @@ void LOOT_WhitelistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->blacklist = false;
     gLastActiveLoot->whitelist = true;
+    gLastActiveLoot->dirty = true;
+  }
+}
+
+void LOOT_Init(void) { mutex = xSemaphoreCreateMutexStatic(&mutexBuffer); }
+
+void LOOT_Lock(void) { xSemaphoreTake(mutex, portMAX_DELAY); }
+
+void LOOT_Unlock(void) { xSemaphoreGive(mutex); }
+
+static uint16_t nowS(void) { return Now() / 1000; }
+
+static void addDuration(Loot *item, uint32_t ms) {
+  if (item != durationItem) {
+    durationItem = item;
+    durationRemMs = 0;
   }
+  ms += durationRemMs;
+  uint32_t d = item->duration + ms / 100;
+  item->duration = d > UINT16_MAX ? UINT16_MAX : d;
+  durationRemMs = ms % 100;
+}
+
+uint32_t LOOT_AgoS(const Loot *item) {
+  const uint16_t ago = nowS() - item->lastTimeOpen;
+  return ago > LOOT_AGO_MAX_S ? LOOT_AGO_MAX_S : ago;
+}
+
+// Pulls stamps older than LOOT_AGO_MAX_S up to it, so 16-bit seconds
+// saturate instead of wrapping. Runs well within the remaining headroom.
+void LOOT_Age(void) {
+  static uint16_t lastAgeS;
+  const uint16_t now = nowS();
+  if ((uint16_t)(now - lastAgeS) < LOOT_AGE_PERIOD_S) {
+    return;
+  }
+  lastAgeS = now;
+  LOOT_Lock();
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    if ((uint16_t)(now - loot[i].lastTimeOpen) > LOOT_AGO_MAX_S) {
+      loot[i].lastTimeOpen = now - LOOT_AGO_MAX_S;
+    }
+  }
+  LOOT_Unlock();
+}
+
+uint32_t LOOT_DurationMs(const Loot *item) { return item->duration * 100; }
+
+uint8_t LOOT_GetCt(const Loot *item) {
+  return item->tone < LOOT_TONE_DCS ? item->tone : LOOT_TONE_NONE;
+}
+
+uint8_t LOOT_GetCd(const Loot *item) {
+  return item->tone != LOOT_TONE_NONE && item->tone >= LOOT_TONE_DCS
+             ? item->tone - LOOT_TONE_DCS
+             : LOOT_TONE_NONE;
 }
 
 Loot *LOOT_Get(uint32_t f) {
@@ -46,7 +119,7 @@ int16_t LOOT_IndexOf(Loot *item) {
   return -1;
 }
 
-Loot *LOOT_AddEx(uint32_t f, bool reuse) {
+static Loot *addEx(uint32_t f, bool reuse) {
   if (reuse) {
     Loot *p = LOOT_Get(f);
     if (p) {
@@ -59,37 +132,55 @@ Loot *LOOT_AddEx(uint32_t f, bool reuse) {
   lastTimeCheck = Now();
   loot[lootIndex] = (Loot){
       .f = f,
-      .lastTimeOpen = Now(),
+      .lastTimeOpen = nowS(),
       .duration = 0,
-      // .snr = UINT8_MAX,
-      .cd = 0xFF,
-      .ct = 0xFF,
+      .tone = LOOT_TONE_NONE,
       .open = true, // as we add it when open
+      .dirty = true,
   };
   return &loot[lootIndex];
 }
 
+Loot *LOOT_AddEx(uint32_t f, bool reuse) {
+  LOOT_Lock();
+  Loot *item = addEx(f, reuse);
+  LOOT_Unlock();
+  return item;
+}
+
 Loot *LOOT_Add(uint32_t f) { return LOOT_AddEx(f, true); }
 
 void LOOT_Remove(uint16_t i) {
+  LOOT_Lock();
   if (LOOT_Size()) {
     for (; i < LOOT_Size() - 1; ++i) {
       loot[i] = loot[i + 1];
     }
     lootIndex--;
+    durationItem = NULL;
+    LOOTJOURNAL_Rebuild();
   }
+  LOOT_Unlock();
 }
 
-void LOOT_Clear(void) { lootIndex = -1; }
+void LOOT_Clear(void) {
+  LOOT_Lock();
+  lootIndex = -1;
+  durationItem = NULL;
+  LOOTJOURNAL_Rebuild();
+  LOOT_Unlock();
+}
 
 uint16_t LOOT_Size(void) { return lootIndex + 1; }
 
 void LOOT_Standby(void) {
+  LOOT_Lock();
   for (uint16_t i = 0; i < LOOT_Size(); ++i) {
     Loot *p = &loot[i];
     p->open = false;
   }
   lastTimeCheck = Now();
+  LOOT_Unlock();
 }
 
 static void swap(Loot *a, Loot *b) {
@@ -99,7 +190,7 @@ static void swap(Loot *a, Loot *b) {
 }
 
 bool LOOT_SortByLastOpenTime(const Loot *a, const Loot *b) {
-  return a->lastTimeOpen < b->lastTimeOpen;
+  return LOOT_AgoS(a) > LOOT_AgoS(b);
 }
 
 bool LOOT_SortByDuration(const Loot *a, const Loot *b) {
@@ -128,8 +219,16 @@ static void Sort(Loot *items, uint16_t n,
   }
 }
 
-void LOOT_Sort(bool (*compare)(const Loot *a, const Loot *b), bool reverse) {
+static void sortLocked(bool (*compare)(const Loot *a, const Loot *b),
+                       bool reverse) {
   Sort(loot, LOOT_Size(), compare, reverse);
+  durationItem = NULL;
+}
+
+void LOOT_Sort(bool (*compare)(const Loot *a, const Loot *b), bool reverse) {
+  LOOT_Lock();
+  sortLocked(compare, reverse);
+  LOOT_Unlock();
 }
 
 Loot *LOOT_Item(uint16_t i) { return &loot[i]; }
@@ -148,7 +247,7 @@ void LOOT_Replace(Measurement *item, uint32_t f) {
   lastTimeCheck = Now();
 }
 
-void LOOT_UpdateEx(Loot *item, Measurement *msm) {
+static void updateEx(Loot *item, Measurement *msm) {
   if (item == NULL) {
     return;
   }
@@ -159,8 +258,12 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
 
   // item->snr = msm->snr;
 
+  if (item->open || msm->open) {
+    item->dirty = true;
+  }
+
   if (item->open) {
-    item->duration += Now() - lastTimeCheck;
+    addDuration(item, Now() - lastTimeCheck);
     gLastActiveLoot = item;
     gLastActiveLootIndex = LOOT_IndexOf(item);
   }
@@ -173,48 +276,60 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
     case BK4819_CSS_RESULT_CDCSS:
       Code = DCS_GetCdcssCode(cd);
       if (Code != 0xFF) {
-        item->cd = Code;
+        item->tone = LOOT_TONE_DCS + Code;
       }
       break;
     case BK4819_CSS_RESULT_CTCSS:
       Code = DCS_GetCtcssCode(ct);
       if (Code != 0xFF) {
-        item->ct = Code;
+        item->tone = Code;
       }
       break;
     default:
       break;
     }
-    item->lastTimeOpen = Now();
+    item->lastTimeOpen = nowS();
   }
   lastTimeCheck = Now();
   item->open = msm->open;
-  msm->ct = item->ct;
-  msm->cd = item->cd;
+  msm->ct = LOOT_GetCt(item);
+  msm->cd = LOOT_GetCd(item);
 
-  if (msm->blacklist) {
+  if (msm->blacklist && !item->blacklist) {
     item->blacklist = true;
+    item->dirty = true;
   }
 }
 
+void LOOT_UpdateEx(Loot *item, Measurement *msm) {
+  LOOT_Lock();
+  updateEx(item, msm);
+  LOOT_Unlock();
+}
+
 void LOOT_Update(Measurement *msm) {
+  LOOT_Lock();
   Loot *item = LOOT_Get(msm->f);
 
   if (item == NULL && msm->open) {
-    item = LOOT_Add(msm->f);
+    item = addEx(msm->f, false);
   }
 
-  LOOT_UpdateEx(item, msm);
+  updateEx(item, msm);
+  LOOT_Unlock();
 }
 
 void LOOT_RemoveBlacklisted(void) {
-  LOOT_Sort(LOOT_SortByBlacklist, true);
+  LOOT_Lock();
+  sortLocked(LOOT_SortByBlacklist, true);
   for (uint16_t i = 0; i < LOOT_Size(); ++i) {
     if (loot[i].blacklist) {
       lootIndex = i;
-      return;
+      LOOTJOURNAL_Rebuild();
+      break;
     }
   }
+  LOOT_Unlock();
 }
 
 CH LOOT_ToCh(const Loot *loot) {
@@ -243,12 +358,12 @@ CH LOOT_ToCh(const Loot *loot) {
 
   snprintf(ch.name, 9, "%u.%05u", ch.rxF / MHZ, ch.rxF % MHZ);
 
-  if (loot->ct != 255) {
+  if (LOOT_GetCt(loot) != LOOT_TONE_NONE) {
     ch.code.tx.type = CODE_TYPE_CONTINUOUS_TONE;
-    ch.code.tx.value = loot->ct;
-  } else if (loot->cd != 255) {
+    ch.code.tx.value = LOOT_GetCt(loot);
+  } else if (LOOT_GetCd(loot) != LOOT_TONE_NONE) {
     ch.code.tx.type = CODE_TYPE_DIGITAL;
-    ch.code.tx.value = loot->cd;
+    ch.code.tx.value = LOOT_GetCd(loot);
   }
 
   return ch;
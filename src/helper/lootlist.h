@@ -6,19 +6,27 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define LOOT_SIZE_MAX 230
+// 9 bytes per item, same RAM as 230 items of the former 16 byte record
+#define LOOT_SIZE_MAX 408
+
+// last open time saturates at ~15.9h, LOOT_Age keeps it from wrapping
+#define LOOT_AGO_MAX_S 0xE000
+#define LOOT_AGE_PERIOD_S 600
+
+#define LOOT_TONE_NONE 0xFF
+#define LOOT_TONE_DCS 50 // tone >= this is DCS index + LOOT_TONE_DCS
 
 typedef struct {
-  uint32_t f;
-  uint32_t lastTimeOpen;
-  uint16_t duration;
-  // uint8_t snr;
-  uint8_t cd;
-  uint8_t ct;
+  uint32_t f : 27;
   bool open : 1;
   bool blacklist : 1;
   bool whitelist : 1;
-} Loot;
+  bool dirty : 1; // changed since last journal flush
+  uint8_t reserved : 1;
+  uint16_t lastTimeOpen; // seconds, see LOOT_Age
+  uint16_t duration;     // 100 ms units
+  uint8_t tone;          // CTCSS index, LOOT_TONE_DCS + DCS index or NONE
+} __attribute__((packed)) Loot;
 
 typedef struct {
   uint32_t f;
@@ -36,6 +44,9 @@ typedef struct {
   bool whitelist : 1;
 } Measurement;
 
+void LOOT_Init(void);
+void LOOT_Lock(void);
+void LOOT_Unlock(void);
 int16_t LOOT_IndexOf(Loot *loot);
 void LOOT_BlacklistLast();
 void LOOT_WhitelistLast();
@@ -58,6 +69,12 @@ bool LOOT_SortByDuration(const Loot *a, const Loot *b);
 bool LOOT_SortByF(const Loot *a, const Loot *b);
 bool LOOT_SortByBlacklist(const Loot *a, const Loot *b);
 
+uint32_t LOOT_AgoS(const Loot *item);
+void LOOT_Age(void);
+uint32_t LOOT_DurationMs(const Loot *item);
+uint8_t LOOT_GetCt(const Loot *item);
+uint8_t LOOT_GetCd(const Loot *item);
+
 void LOOT_RemoveBlacklisted(void);
 CH LOOT_ToCh(const Loot *loot);
 
@@ -33,6 +33,58 @@ uint32_t ConvertDomainF(uint32_t aValue, uint32_t aMin, uint32_t aMax,
   return (uint32_t)ClampF(result, bMin, bMax);
 }
 
+// The only 64-bit divide happens here, once per range change
+void DomainMapF_Init(DomainMapF *map, uint32_t fMin, uint32_t fMax,
+                     uint8_t xMax) {
+  map->fMin = fMin;
+  map->fMax = fMax;
+  map->xMax = xMax;
+  map->q = 0;
+  map->r = 0;
+  map->scale = 0;
+  map->rcp = 0;
+  if (fMax <= fMin || !xMax) {
+    return;
+  }
+  const uint32_t fRange = fMax - fMin;
+  map->q = fRange / xMax;
+  map->r = fRange % xMax;
+  map->scale = ((uint64_t)xMax << 32) / fRange;
+  map->rcp = ((1UL << 24) + xMax - 1) / xMax;
+}
+
+uint8_t DomainMapF_ToX(const DomainMapF *map, uint32_t f) {
+  if (map->fMax < map->fMin) {
+    return ConvertDomainF(f, map->fMin, map->fMax, 0, map->xMax);
+  }
+  if (map->fMax == map->fMin) {
+    return 0;
+  }
+  const uint32_t fRange = map->fMax - map->fMin;
+  const uint32_t d = ClampF(f, map->fMin, map->fMax) - map->fMin;
+
+  // scale is floored, so estimate is at most 2 below the rounded result
+  uint32_t x = (d * map->scale) >> 32;
+  const uint64_t num = (uint64_t)d * map->xMax + fRange / 2;
+  while (x < map->xMax && num >= (uint64_t)(x + 1) * fRange) {
+    x++;
+  }
+  return x;
+}
+
+// (x * fRange + xMax / 2) / xMax split as x * q + (x * r + xMax / 2) / xMax;
+// the remainder part is < 2^16, so reciprocal multiply is exact
+uint32_t DomainMapF_ToF(const DomainMapF *map, uint8_t x) {
+  if (map->fMax <= map->fMin) {
+    return ConvertDomainF(x, 0, map->xMax, map->fMin, map->fMax);
+  }
+  if (x > map->xMax) {
+    x = map->xMax;
+  }
+  const uint32_t n = (uint32_t)x * map->r + map->xMax / 2;
+  return map->fMin + x * map->q + (uint32_t)(((uint64_t)n * map->rcp) >> 24);
+}
+
 uint8_t DBm2S(int dbm, bool isVHF) {
   uint8_t i = 0;
   dbm *= -1;
@@ -17,6 +17,17 @@ typedef struct {
   uint8_t gc;
 } SQL;
 
+// precomputed frequency <-> pixel mapping, same rounding as ConvertDomainF
+typedef struct {
+  uint32_t fMin;
+  uint32_t fMax;
+  uint32_t q;     // (fMax - fMin) / xMax
+  uint64_t scale; // (xMax << 32) / (fMax - fMin)
+  uint32_t rcp;   // ceil(2^24 / xMax)
+  uint8_t r;      // (fMax - fMin) % xMax
+  uint8_t xMax;
+} DomainMapF;
+
 static const uint8_t rssi2s[2][15] = {
     {121, 115, 109, 103, 97, 91, 85, 79, 73, 63, 53, 43, 33, 23, 13},
     {141, 135, 129, 123, 117, 111, 105, 99, 93, 83, 73, 63, 53, 43, 33},
@@ -27,6 +38,10 @@ int ConvertDomain(int aValue, int aMin, int aMax, int bMin, int bMax);
 uint32_t ClampF(uint32_t v, uint32_t min, uint32_t max);
 uint32_t ConvertDomainF(uint32_t aValue, uint32_t aMin, uint32_t aMax,
                         uint32_t bMin, uint32_t bMax);
+void DomainMapF_Init(DomainMapF *map, uint32_t fMin, uint32_t fMax,
+                     uint8_t xMax);
+uint8_t DomainMapF_ToX(const DomainMapF *map, uint32_t f);
+uint32_t DomainMapF_ToF(const DomainMapF *map, uint8_t x);
 uint8_t Rssi2PX(uint16_t rssi, uint8_t pxMin, uint8_t pxMax);
 uint8_t DBm2S(int dbm, bool isVHF);
 int Rssi2DBm(uint16_t rssi);
@@ -0,0 +1,294 @@
+#include "nvring.h"
+#include "../driver/eeprom.h"
+#include "../driver/uart.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/semphr.h"
+#include "../settings.h"
+#include "channels.h"
+#include <stddef.h>
+#include <string.h>
+
+// Write-back ring for hot records (settings, VFOs, current band).
+// Each save goes to the next free page-sized slot under a new sequence
+// number, so a knob turn never rewrites the same page twice in a row.
+// At boot the newest valid copy per key wins; a FENCE record voids
+// everything older (used when home locations become authoritative again).
+// Slots still holding newest copy are skipped, when all are taken the one
+// at head is written back to its home location. Newest fence keeps its slot,
+// so voided records can't come back after it is overwritten.
+
+typedef struct {
+  uint32_t seq;
+  uint16_t key;
+  uint16_t crc;
+} SlotHeader;
+
+#define HDR_SIZE sizeof(SlotHeader)
+#define PAYLOAD_MAX (CH_SIZE > SETTINGS_SIZE ? CH_SIZE : SETTINGS_SIZE)
+
+static uint32_t base = 0; // 0: disabled
+static uint16_t slotSize;
+static uint16_t slotKey[NVRING_SLOTS];
+static uint8_t head;
+
+static uint8_t buf[HDR_SIZE + PAYLOAD_MAX];
+
+static NvRingStats stats;
+
+static StaticSemaphore_t mutexBuffer;
+static SemaphoreHandle_t mutex;
+
+static uint16_t crc16(uint16_t crc, const uint8_t *p, uint16_t n) {
+  while (n--) {
+    crc ^= *p++ << 8;
+    for (uint8_t i = 0; i < 8; ++i) {
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint16_t keySize(uint16_t key) {
+  if (key == NVRING_KEY_FENCE) {
+    return 0;
+  }
+  return key == NVRING_KEY_SETTINGS ? SETTINGS_SIZE : CH_SIZE;
+}
+
+static bool keyValid(uint16_t key) {
+  return key == NVRING_KEY_SETTINGS || key == NVRING_KEY_FENCE ||
+         key < CHANNELS_GetCountMax();
+}
+
+static uint32_t homeAddr(uint16_t key) {
+  return key == NVRING_KEY_SETTINGS ? SETTINGS_OFFSET
+                                    : CHANNELS_OFFSET + key * CH_SIZE;
+}
+
+static uint32_t slotAddr(uint8_t slot) { return base + slot * slotSize; }
+
+static uint16_t slotCrc(const SlotHeader *h, const uint8_t *payload) {
+  uint16_t crc = crc16(0xFFFF, (const uint8_t *)h, offsetof(SlotHeader, crc));
+  return crc16(crc, payload, keySize(h->key));
+}
+
+static int8_t findLive(uint16_t key) {
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    if (slotKey[i] == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void writeSlot(uint8_t slot, uint16_t key, const void *p,
+                      uint16_t size) {
+  SlotHeader *h = (SlotHeader *)buf;
+  h->seq = ++stats.seq;
+  h->key = key;
+  if (size) {
+    memcpy(buf + HDR_SIZE, p, size);
+  }
+  h->crc = slotCrc(h, buf + HDR_SIZE);
+  EEPROM_WriteBuffer(slotAddr(slot), buf, HDR_SIZE + size);
+  stats.writes[slot]++;
+}
+
+static void writeBack(uint8_t slot) {
+  const uint16_t key = slotKey[slot];
+  EEPROM_ReadBuffer(slotAddr(slot) + HDR_SIZE, buf, keySize(key));
+  EEPROM_WriteBuffer(homeAddr(key), buf, keySize(key));
+  slotKey[slot] = NVRING_KEY_FREE;
+  stats.evictions++;
+}
+
+// next slot not holding newest copy of another key
+static uint8_t takeSlot(int8_t own) {
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    const uint8_t slot = head;
+    head = (head + 1) % NVRING_SLOTS;
+    if (slotKey[slot] == NVRING_KEY_FREE || slot == own) {
+      return slot;
+    }
+  }
+  uint8_t slot = head;
+  while (slotKey[slot] == NVRING_KEY_FENCE) {
+    slot = (slot + 1) % NVRING_SLOTS;
+  }
+  head = (slot + 1) % NVRING_SLOTS;
+  writeBack(slot);
+  return slot;
+}
+
+static bool isData(uint8_t slot) {
+  return slotKey[slot] != NVRING_KEY_FREE &&
+         slotKey[slot] != NVRING_KEY_FENCE;
+}
+
+static uint8_t countLive(void) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    n += isData(i);
+  }
+  return n;
+}
+
+static void fence(void) {
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    slotKey[i] = NVRING_KEY_FREE;
+  }
+  const uint8_t slot = takeSlot(-1);
+  writeSlot(slot, NVRING_KEY_FENCE, NULL, 0);
+  slotKey[slot] = NVRING_KEY_FENCE;
+  stats.live = 0;
+}
+
+void NVRING_Init(void) {
+  if (!mutex) {
+    mutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
+  }
+
+  base = 0;
+  memset(&stats, 0, sizeof(stats));
+  slotSize = SETTINGS_GetPageSize();
+
+  uint32_t start, end;
+  CHANNELS_GetFreeArea(&start, &end);
+  const uint32_t ringSize = NVRING_SLOTS * slotSize;
+  if (slotSize < sizeof(buf) || end < ringSize ||
+      (end - ringSize) / slotSize * slotSize < start) {
+    Log("NVR no room");
+    return;
+  }
+  base = (end - ringSize) / slotSize * slotSize;
+
+  uint32_t seqs[NVRING_SLOTS];
+  uint32_t fenceSeq = 0;
+  uint8_t newest = NVRING_SLOTS - 1;
+
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    SlotHeader *h = (SlotHeader *)buf;
+    slotKey[i] = NVRING_KEY_FREE;
+    seqs[i] = 0;
+    EEPROM_ReadBuffer(slotAddr(i), buf, HDR_SIZE);
+    if (!keyValid(h->key)) {
+      continue;
+    }
+    EEPROM_ReadBuffer(slotAddr(i) + HDR_SIZE, buf + HDR_SIZE, keySize(h->key));
+    if (h->crc != slotCrc(h, buf + HDR_SIZE)) {
+      continue;
+    }
+    slotKey[i] = h->key;
+    seqs[i] = h->seq;
+    if (h->seq > stats.seq) {
+      stats.seq = h->seq;
+      newest = i;
+    }
+    if (h->key == NVRING_KEY_FENCE && h->seq > fenceSeq) {
+      fenceSeq = h->seq;
+    }
+  }
+
+  // keep only newest copy per key, younger than last fence
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    if (slotKey[i] == NVRING_KEY_FREE) {
+      continue;
+    }
+    bool stale = seqs[i] < fenceSeq;
+    for (uint8_t j = 0; j < NVRING_SLOTS && !stale; ++j) {
+      stale = slotKey[j] == slotKey[i] && seqs[j] > seqs[i];
+    }
+    if (stale) {
+      slotKey[i] = NVRING_KEY_FREE;
+    }
+  }
+  head = (newest + 1) % NVRING_SLOTS;
+  stats.live = countLive();
+  Log("NVR @%u slot=%u seq=%u live=%u", base, slotSize, stats.seq, stats.live);
+}
+
+bool NVRING_IsAvailable(void) { return base != 0; }
+
+uint32_t NVRING_GetStart(void) { return base; }
+
+bool NVRING_Has(uint16_t key) { return base && findLive(key) >= 0; }
+
+bool NVRING_Read(uint16_t key, uint16_t offset, void *p, uint16_t size) {
+  if (!base) {
+    return false;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const int8_t slot = findLive(key);
+  if (slot >= 0) {
+    EEPROM_ReadBuffer(slotAddr(slot) + HDR_SIZE + offset, p, size);
+  }
+  xSemaphoreGive(mutex);
+  return slot >= 0;
+}
+
+bool NVRING_Write(uint16_t key, const void *p, uint16_t size) {
+  if (!base || size != keySize(key)) {
+    return false;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const int8_t own = findLive(key);
+  const uint8_t slot = takeSlot(own);
+  writeSlot(slot, key, p, size);
+  if (own >= 0 && own != slot) {
+    slotKey[own] = NVRING_KEY_FREE;
+  }
+  slotKey[slot] = key;
+  stats.live = countLive();
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+// home locations get newest data, ring content becomes void
+void NVRING_Sync(void) {
+  if (!base) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (countLive()) {
+    for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+      if (isData(i)) {
+        writeBack(i);
+      }
+    }
+    fence();
+  }
+  xSemaphoreGive(mutex);
+}
+
+// home locations were rewritten (reset), ring content becomes void
+void NVRING_Discard(void) {
+  if (!base) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (countLive()) {
+    fence();
+  }
+  xSemaphoreGive(mutex);
+}
+
+void NVRING_Disable(void) { base = 0; }
+
+const NvRingStats *NVRING_GetStats(void) { return &stats; }
+
+void NVRING_LogStats(void) {
+  uint16_t min = UINT16_MAX, max = 0;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < NVRING_SLOTS; ++i) {
+    const uint16_t w = stats.writes[i];
+    sum += w;
+    if (w < min) {
+      min = w;
+    }
+    if (w > max) {
+      max = w;
+    }
+  }
+  Log("NVR seq=%u live=%u evict=%u writes=%u min=%u max=%u", stats.seq,
+      stats.live, stats.evictions, sum, min, max);
+}
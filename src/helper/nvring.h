@@ -0,0 +1,32 @@
+#ifndef NVRING_H
+#define NVRING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NVRING_SLOTS 32 // one EEPROM page each
+
+#define NVRING_KEY_SETTINGS 0x7FFF
+#define NVRING_KEY_FENCE 0x7FFE
+#define NVRING_KEY_FREE 0xFFFF
+
+typedef struct {
+  uint32_t seq;       // total ring writes over EEPROM lifetime
+  uint16_t evictions; // write-backs to home location since boot
+  uint8_t live;
+  uint16_t writes[NVRING_SLOTS]; // per slot since boot
+} NvRingStats;
+
+void NVRING_Init(void);
+bool NVRING_IsAvailable(void);
+uint32_t NVRING_GetStart(void);
+bool NVRING_Has(uint16_t key);
+bool NVRING_Read(uint16_t key, uint16_t offset, void *p, uint16_t size);
+bool NVRING_Write(uint16_t key, const void *p, uint16_t size);
+void NVRING_Sync(void);
+void NVRING_Discard(void);
+void NVRING_Disable(void);
+const NvRingStats *NVRING_GetStats(void);
+void NVRING_LogStats(void);
+
+#endif /* end of include guard: NVRING_H */
@@ -0,0 +1,115 @@
+#include "probe.h"
+#include "../driver/bk4819.h"
+#include "../driver/uart.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include "../radio.h"
+#include "../scheduler.h"
+#include "../svc.h"
+
+// Host-driven measurement batch. Runs in app update task instead of current
+// app, so nothing else retunes the radio meanwhile. Results go out in bulk
+// frames of PROBE_FRAME_RECORDS, then VFO setup is restored.
+
+static ProbeJob job;
+static uint32_t list[PROBE_LIST_MAX];
+static uint8_t listSize;
+
+static volatile bool active;
+static volatile bool cancel;
+static bool started;
+static uint16_t index;
+static uint32_t startedAt;
+static uint8_t savedGain;
+
+static ProbeRecord records[PROBE_FRAME_RECORDS];
+
+ProbeStatus PROBE_Start(const ProbeJob *p, const uint32_t *l, uint8_t n) {
+  if (active || SVC_RadioBusy()) {
+    return PROBE_BUSY;
+  }
+  if (RADIO_GetRadio() != RADIO_BK4819) {
+    return PROBE_BAD_RADIO;
+  }
+  if (n > PROBE_LIST_MAX || (!n && !p->count) ||
+      (p->bw != PROBE_KEEP && p->bw > BK4819_FILTER_BW_26k) ||
+      (p->gainIndex != PROBE_KEEP && p->gainIndex >= ARRAY_SIZE(gainTable))) {
+    return PROBE_BAD_ARGS;
+  }
+
+  job = *p;
+  listSize = n;
+  for (uint8_t i = 0; i < n; ++i) {
+    list[i] = l[i];
+  }
+  if (n) {
+    job.count = n;
+  }
+  index = 0;
+  started = false;
+  cancel = false;
+  active = true;
+  return PROBE_OK;
+}
+
+void PROBE_Cancel(void) { cancel = true; }
+
+static void begin(void) {
+  started = true;
+  startedAt = Now();
+  savedGain = radio->gainIndex;
+  RADIO_ToggleRX(false);
+  if (job.bw != PROBE_KEEP) {
+    RADIO_SetFilterBandwidth(job.bw);
+  }
+  if (job.gainIndex != PROBE_KEEP) {
+    RADIO_SetGain(job.gainIndex);
+  }
+}
+
+static void finish(void) {
+  radio->gainIndex = savedGain;
+  RADIO_Setup();
+  RADIO_TuneToPure(radio->rxF, true);
+  Log("PROBE %u pts in %ums", index, Now() - startedAt);
+  active = false;
+}
+
+static void measure(uint32_t f, ProbeRecord *r) {
+  RADIO_TuneToPure(f, job.precise);
+  vTaskDelay((job.settleUs + 99) / 100);
+  r->f = f;
+  r->rssi = RADIO_GetRSSI();
+  r->noise = BK4819_GetNoise();
+  r->glitch = BK4819_GetGlitch();
+  r->snr = RADIO_GetSNR();
+  r->open = RADIO_IsSquelchOpen();
+}
+
+// true while batch owns the radio
+bool PROBE_Update(void) {
+  if (!active) {
+    return false;
+  }
+  if (!started) {
+    begin();
+  }
+
+  uint8_t n = 0;
+  while (n < PROBE_FRAME_RECORDS && index + n < job.count && !cancel) {
+    const uint16_t i = index + n;
+    measure(listSize ? list[i] : job.startF + job.step * i, &records[n]);
+    n++;
+  }
+
+  const bool last = cancel || index + n >= job.count;
+  while (!UART_SendProbeRecords(index, records, n, last, Now() - startedAt)) {
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  index += n;
+
+  if (last) {
+    finish();
+  }
+  return true;
+}
@@ -0,0 +1,41 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROBE_LIST_MAX 32
+#define PROBE_FRAME_RECORDS 20
+#define PROBE_KEEP 0xFF // bw/gain: leave as set by current VFO
+
+typedef enum {
+  PROBE_OK,
+  PROBE_BUSY,
+  PROBE_BAD_RADIO,
+  PROBE_BAD_ARGS,
+} ProbeStatus;
+
+typedef struct {
+  uint32_t f;
+  uint16_t rssi;
+  uint8_t noise;
+  uint8_t glitch;
+  uint8_t snr;
+  bool open;
+} __attribute__((packed)) ProbeRecord;
+
+typedef struct {
+  uint32_t startF; // range mode, unused with list
+  uint32_t step;
+  uint16_t count;
+  uint16_t settleUs;
+  uint8_t bw;
+  uint8_t gainIndex;
+  bool precise;
+} ProbeJob;
+
+ProbeStatus PROBE_Start(const ProbeJob *job, const uint32_t *list, uint8_t n);
+void PROBE_Cancel(void);
+bool PROBE_Update(void);
+
+#endif /* end of include guard: PROBE_H */
@@ -0,0 +1,253 @@
+#include "rds.h"
+#include "../driver/si473x.h"
+#include "../driver/st7565.h"
+#include "../driver/uart.h"
+#include "../misc.h"
+#include <string.h>
+
+// SI4732 RDS FIFO is drained into RAM ring by background service, groups
+// are decoded from ring a few per call, so reading keeps up with chip even
+// when decoding lags. Screens only read gRDS, no bus work.
+// Blocks with 3-5 corrected bits are dropped as likely miscorrected, PI is
+// taken after two equal blocks, PS is shown only once all 4 segments came.
+
+#define FIFO_READS_MAX 8
+#define DECODE_PER_UPDATE 4
+#define POLL_MS 100
+#define IDLE_MS 500
+#define BLE_MAX 1 // 0: no errors, 1: 1-2 bits corrected
+
+#define PS_ALL 0x0F
+
+enum { BLOCK_A, BLOCK_B, BLOCK_C, BLOCK_D };
+
+typedef struct {
+  uint16_t block[4];
+  uint8_t ble;
+} RdsGroup;
+
+RDS gRDS;
+RDSStats gRDSStats;
+
+static RdsGroup ring[RDS_RING_SIZE];
+static uint8_t ringHead;
+static uint8_t ringCount;
+
+static uint16_t piCandidate;
+static char psBuf[8];
+static uint8_t psSegments;
+static bool rtAb;
+
+static uint16_t tunedFreq;
+
+static void clearData(void) {
+  memset(&gRDS, 0, sizeof(gRDS));
+  memset(gRDS.rt, ' ', RDS_RT_SIZE);
+  psSegments = 0;
+}
+
+void RDS_Reset(void) {
+  if (gRDSStats.received) {
+    Log("RDS %04X rx %u dec %u drop %u ovf %u", gRDS.pi, gRDSStats.received,
+        gRDSStats.decoded, gRDSStats.dropped, gRDSStats.overflows);
+  }
+  clearData();
+  memset(&gRDSStats, 0, sizeof(gRDSStats));
+  ringCount = 0;
+  piCandidate = 0;
+  tunedFreq = siCurrentFreq;
+}
+
+static void fill(void) {
+  uint8_t buf[13];
+  bool overflow = false;
+  for (uint8_t n = 0; n < FIFO_READS_MAX; ++n) {
+    SI47XX_ReadRDS(buf);
+    gRDS.sync = buf[2] & FIELD_RDS_STATUS_RESP2_SYNC;
+    overflow |= buf[2] & FIELD_RDS_STATUS_RESP2_FIFO_OVERFLOW;
+    if (!buf[3]) {
+      break;
+    }
+    gRDSStats.received++;
+    if (ringCount == RDS_RING_SIZE) {
+      gRDSStats.dropped++;
+      continue;
+    }
+    RdsGroup *g = &ring[(ringHead + ringCount) % RDS_RING_SIZE];
+    for (uint8_t i = 0; i < 4; ++i) {
+      g->block[i] = MAKE_WORD(buf[4 + i * 2], buf[5 + i * 2]);
+    }
+    g->ble = buf[12];
+    ringCount++;
+  }
+  if (overflow) {
+    gRDSStats.overflows++;
+  }
+}
+
+static bool blockOk(const RdsGroup *g, uint8_t i) {
+  return ((g->ble >> (6 - i * 2)) & 3) <= BLE_MAX;
+}
+
+static char rdsChar(uint8_t c) { return c >= 0x20 && c < 0x7F ? c : '?'; }
+
+static bool updatePi(uint16_t pi) {
+  if (pi == gRDS.pi) {
+    return false;
+  }
+  if (pi != piCandidate) {
+    piCandidate = pi;
+    return false;
+  }
+  if (gRDS.pi) {
+    clearData(); // other station on same frequency
+  }
+  gRDS.pi = pi;
+  return true;
+}
+
+static bool updatePs(uint8_t seg, uint16_t d) {
+  psBuf[seg * 2] = rdsChar(d >> 8);
+  psBuf[seg * 2 + 1] = rdsChar(d);
+  psSegments |= 1 << seg;
+  if (psSegments != PS_ALL) {
+    return false;
+  }
+  psSegments = 0;
+  if (!memcmp(gRDS.ps, psBuf, sizeof(psBuf))) {
+    return false;
+  }
+  memcpy(gRDS.ps, psBuf, sizeof(psBuf));
+  return true;
+}
+
+static void rtPut(uint8_t pos, uint8_t c) {
+  if (pos >= RDS_RT_SIZE) {
+    return;
+  }
+  gRDS.rt[pos] = c == '\r' ? '\0' : rdsChar(c);
+}
+
+static bool updateRt(const RdsGroup *g, bool versionB) {
+  const uint16_t b = g->block[BLOCK_B];
+  const bool ab = b & (1 << 4);
+  if (ab != rtAb) {
+    rtAb = ab;
+    memset(gRDS.rt, ' ', RDS_RT_SIZE);
+  }
+  const uint8_t seg = b & 0x0F;
+  const uint16_t d = g->block[BLOCK_D];
+  if (versionB) {
+    rtPut(seg * 2, d >> 8);
+    rtPut(seg * 2 + 1, d);
+    return true;
+  }
+  const uint16_t c = g->block[BLOCK_C];
+  if (!blockOk(g, BLOCK_C)) {
+    return false;
+  }
+  rtPut(seg * 4, c >> 8);
+  rtPut(seg * 4 + 1, c);
+  rtPut(seg * 4 + 2, d >> 8);
+  rtPut(seg * 4 + 3, d);
+  return true;
+}
+
+// MJD to date, integer form of the formula in IEC 62106 annex G
+static bool updateCt(const RdsGroup *g) {
+  if (!blockOk(g, BLOCK_C)) {
+    return false;
+  }
+  const uint16_t b = g->block[BLOCK_B];
+  const uint16_t c = g->block[BLOCK_C];
+  const uint16_t d = g->block[BLOCK_D];
+
+  int32_t mjd = ((uint32_t)(b & 3) << 15) | (c >> 1);
+  int32_t min = (((c & 1) << 4) | (d >> 12)) * 60 + ((d >> 6) & 0x3F);
+  const int16_t offset = (d & 0x1F) * 30;
+  min += d & (1 << 5) ? -offset : offset;
+  if (min < 0) {
+    min += 24 * 60;
+    mjd--;
+  } else if (min >= 24 * 60) {
+    min -= 24 * 60;
+    mjd++;
+  }
+
+  const int32_t y = (mjd * 100 - 1507820) / 36525;
+  const int32_t t = mjd - 14956 - y * 36525 / 100;
+  const int32_t m = (t * 10000 - 1000) / 306001;
+  const uint8_t k = m == 14 || m == 15;
+
+  gRDS.day = t - m * 306001 / 10000;
+  gRDS.month = m - 1 - k * 12;
+  gRDS.year = y + k + 1900;
+  gRDS.hour = min / 60;
+  gRDS.minute = min % 60;
+  gRDS.ct = true;
+  return true;
+}
+
+static bool decode(const RdsGroup *g) {
+  bool changed = false;
+  if (blockOk(g, BLOCK_A)) {
+    changed = updatePi(g->block[BLOCK_A]);
+  }
+  if (!blockOk(g, BLOCK_B)) {
+    return changed;
+  }
+  gRDSStats.decoded++;
+
+  const uint16_t b = g->block[BLOCK_B];
+  gRDS.tp = b & (1 << 10);
+  gRDS.pty = (b >> 5) & 0x1F;
+
+  const bool dOk = blockOk(g, BLOCK_D);
+  switch (b >> 11) { // group type and version
+  case 0x00: // 0A
+  case 0x01: // 0B
+    gRDS.ta = b & (1 << 4);
+    return (dOk && updatePs(b & 3, g->block[BLOCK_D])) || changed;
+  case 0x04: // 2A
+  case 0x05: // 2B
+    return (dOk && updateRt(g, b & (1 << 11))) || changed;
+  case 0x08: // 4A
+    return (dOk && updateCt(g)) || changed;
+  default:
+    return changed;
+  }
+}
+
+static bool decodeSome(uint8_t max) {
+  bool changed = false;
+  for (; ringCount && max; --max) {
+    changed |= decode(&ring[ringHead]);
+    ringHead = (ringHead + 1) % RDS_RING_SIZE;
+    ringCount--;
+  }
+  return changed;
+}
+
+// drains chip FIFO and decodes all, true if anything shown changed
+bool RDS_Poll(void) {
+  fill();
+  return decodeSome(RDS_RING_SIZE);
+}
+
+bool RDS_PsReady(void) { return gRDS.ps[0] != '\0'; }
+
+void RDS_svcInit(void) { RDS_Reset(); }
+
+uint16_t RDS_svcUpdate(void) {
+  if (!isSi4732On || si4732mode != SI47XX_FM) {
+    return IDLE_MS;
+  }
+  if (siCurrentFreq != tunedFreq) {
+    RDS_Reset();
+  }
+  fill();
+  if (decodeSome(DECODE_PER_UPDATE)) {
+    gRedrawScreen = true;
+  }
+  return POLL_MS;
+}
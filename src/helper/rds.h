@@ -0,0 +1,44 @@
+#ifndef RDS_H
+#define RDS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RDS_RING_SIZE 8
+#define RDS_RT_SIZE 64
+
+typedef struct {
+  uint16_t pi; // 0 until confirmed by two groups
+  uint8_t pty;
+  bool tp;
+  bool ta;
+  bool sync;
+  char ps[9]; // empty until all 4 segments came
+  char rt[RDS_RT_SIZE + 1];
+  bool ct; // clock time below is valid
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t day;
+  uint8_t month;
+  uint16_t year;
+} RDS;
+
+// groups since last reset (tune)
+typedef struct {
+  uint32_t received; // read from chip FIFO
+  uint32_t decoded;  // block B usable, group applied
+  uint16_t dropped;  // ring full, never decoded
+  uint16_t overflows; // chip FIFO overflowed between polls
+} RDSStats;
+
+extern RDS gRDS;
+extern RDSStats gRDSStats;
+
+void RDS_Reset(void);
+bool RDS_Poll(void);
+bool RDS_PsReady(void);
+
+void RDS_svcInit(void);
+uint16_t RDS_svcUpdate(void);
+
+#endif /* end of include guard: RDS_H */
@@ -0,0 +1,234 @@
+#include "toneseq.h"
+#include "../driver/audio.h"
+#include "../driver/bk4819.h"
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include "../external/FreeRTOS/include/timers.h"
+#include "../settings.h"
+#include <string.h>
+
+// Plays tone programs from one-shot software timer, so callers never wait
+// for the sequence to end. Steps are pulled from source one at a time, so
+// DTMF strings and CW text need no expanded copy. Timer only wakes worker
+// task, every step runs there from TONESEQ_Update, so BK4819 writes never
+// cut into radio code of that task and timer task delays can't stretch
+// them past one tick. onDone is called there after tx audio is muted again
+// (not after a held tone).
+
+typedef enum {
+  SEQ_IDLE,
+  SEQ_LEAD, // local speaker turns on after tone is set up
+  SEQ_STEP,
+  SEQ_TAIL, // local speaker turned off, tx mute pending
+} SeqState;
+
+#define SPEAKER_MS 10
+
+static StaticTimer_t timerBuffer;
+static TimerHandle_t timer;
+
+static volatile SeqState state = SEQ_IDLE;
+static volatile bool stepDue;
+static ToneSource source;
+static void (*onDone)(void);
+static TaskHandle_t worker;
+static bool toneSet;
+static bool speakerOn;
+static uint16_t stepMs;
+
+static const uint16_t *prog;
+
+static char dtmf[32];
+static uint8_t dtmfPos;
+static uint16_t dtmfLead;
+static uint16_t dtmfTone;
+static uint16_t dtmfGap;
+static bool dtmfKeyed;
+
+static void schedule(uint16_t ms) {
+  const TickType_t ticks = pdMS_TO_TICKS(ms);
+  xTimerChangePeriod(timer, ticks ? ticks : 1, 0);
+}
+
+static void play(const ToneStep *s) {
+  if (!s->note) {
+    BK4819_EnterTxMute();
+    return;
+  }
+  if (s->note & TONESEQ_DTMF(0)) {
+    BK4819_PlayDTMF(s->note & 0xFF);
+    BK4819_ExitTxMute();
+    return;
+  }
+  if (toneSet) {
+    BK4819_SetToneFrequency(s->note);
+    BK4819_ExitTxMute();
+    return;
+  }
+  toneSet = true;
+  BK4819_TransmitTone(s->note);
+  if (gSettings.toneLocal) {
+    state = SEQ_LEAD;
+  }
+}
+
+// true when sequence is over
+static bool advance(void) {
+  switch (state) {
+  case SEQ_LEAD:
+    AUDIO_ToggleSpeaker(true);
+    speakerOn = true;
+    if (!stepMs) {
+      state = SEQ_IDLE;
+      return true;
+    }
+    state = SEQ_STEP;
+    schedule(stepMs);
+    return false;
+
+  case SEQ_TAIL:
+    BK4819_EnterTxMute();
+    state = SEQ_IDLE;
+    return true;
+
+  default:
+    break;
+  }
+
+  ToneStep s;
+  if (!source(&s)) {
+    if (speakerOn) {
+      AUDIO_ToggleSpeaker(false);
+      speakerOn = false;
+      state = SEQ_TAIL;
+      schedule(SPEAKER_MS);
+      return false;
+    }
+    BK4819_EnterTxMute();
+    state = SEQ_IDLE;
+    return true;
+  }
+
+  stepMs = s.ms;
+  play(&s);
+  if (state == SEQ_LEAD) {
+    schedule(SPEAKER_MS);
+    return false;
+  }
+  if (!s.ms) {
+    state = SEQ_IDLE;
+    return true;
+  }
+  schedule(s.ms);
+  return false;
+}
+
+static void timerCallback(TimerHandle_t t) {
+  stepDue = true;
+  xTaskNotifyGive(worker);
+}
+
+void TONESEQ_Init(TaskHandle_t task) { worker = task; }
+
+// in worker task
+void TONESEQ_Update(void) {
+  if (!stepDue) {
+    return;
+  }
+  vTaskSuspendAll();
+  stepDue = false;
+  const bool done = state != SEQ_IDLE && advance();
+  void (*cb)(void) = done ? onDone : NULL;
+  xTaskResumeAll();
+  if (cb) {
+    cb();
+  }
+}
+
+// first step runs in worker too, right after it wakes
+void TONESEQ_Run(ToneSource src, void (*done)(void)) {
+  vTaskSuspendAll();
+  if (!timer) {
+    timer = xTimerCreateStatic("TSQ", 1, pdFALSE, NULL, timerCallback,
+                               &timerBuffer);
+  }
+  xTimerStop(timer, 0);
+  source = src;
+  onDone = done;
+  toneSet = false;
+  speakerOn = false;
+  state = SEQ_STEP;
+  stepDue = true;
+  xTaskResumeAll();
+  xTaskNotifyGive(worker);
+}
+
+static bool progNext(ToneStep *s) {
+  if (!prog[0] && !prog[1]) {
+    return false;
+  }
+  s->note = *prog++;
+  s->ms = *prog++;
+  return true;
+}
+
+// M: {note, ms} pairs ending with {0, 0}, must outlive the sequence
+void TONESEQ_Play(const uint16_t *M, void (*done)(void)) {
+  TONESEQ_Stop();
+  prog = M;
+  TONESEQ_Run(progNext, done);
+}
+
+static bool dtmfNext(ToneStep *s) {
+  if (dtmfLead) {
+    s->note = 0;
+    s->ms = dtmfLead;
+    dtmfLead = 0;
+    return true;
+  }
+  if (dtmfKeyed) {
+    s->note = 0;
+    s->ms = dtmfGap;
+    dtmfKeyed = false;
+    return true;
+  }
+  if (!dtmf[dtmfPos]) {
+    return false;
+  }
+  s->note = TONESEQ_DTMF(dtmf[dtmfPos++]);
+  s->ms = dtmfTone;
+  dtmfKeyed = true;
+  return true;
+}
+
+// expects BK4819_EnterDTMF_TX done by caller
+void TONESEQ_PlayDTMF(const char *str, uint16_t leadMs, uint16_t toneMs,
+                      uint16_t gapMs, void (*done)(void)) {
+  TONESEQ_Stop();
+  strncpy(dtmf, str, sizeof(dtmf) - 1);
+  dtmfPos = 0;
+  dtmfLead = leadMs;
+  dtmfTone = toneMs;
+  dtmfGap = gapMs;
+  dtmfKeyed = false;
+  TONESEQ_Run(dtmfNext, done);
+}
+
+void TONESEQ_Stop(void) {
+  vTaskSuspendAll();
+  if (timer) {
+    xTimerStop(timer, 0);
+  }
+  stepDue = false; // caller stopping it tears down itself
+  if (state != SEQ_IDLE) {
+    if (speakerOn) {
+      AUDIO_ToggleSpeaker(false);
+      speakerOn = false;
+    }
+    BK4819_EnterTxMute();
+    state = SEQ_IDLE;
+  }
+  xTaskResumeAll();
+}
+
+bool TONESEQ_IsBusy(void) { return state != SEQ_IDLE; }
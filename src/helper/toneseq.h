@@ -0,0 +1,29 @@
+#ifndef TONESEQ_H
+#define TONESEQ_H
+
+#include "../external/FreeRTOS/include/FreeRTOS.h"
+#include "../external/FreeRTOS/include/task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// note values: tone in Hz, 0 for silence (tx muted)
+#define TONESEQ_DTMF(c) (0x8000 | (uint8_t)(c))
+
+typedef struct {
+  uint16_t note;
+  uint16_t ms; // 0 with note: tone stays on, sequence ends
+} ToneStep;
+
+// fills next step, false at end of program
+typedef bool (*ToneSource)(ToneStep *step);
+
+void TONESEQ_Init(TaskHandle_t worker);
+void TONESEQ_Update(void);
+void TONESEQ_Run(ToneSource source, void (*onDone)(void));
+void TONESEQ_Play(const uint16_t *M, void (*onDone)(void));
+void TONESEQ_PlayDTMF(const char *str, uint16_t leadMs, uint16_t toneMs,
+                      uint16_t gapMs, void (*onDone)(void));
+void TONESEQ_Stop(void);
+bool TONESEQ_IsBusy(void);
+
+#endif /* end of include guard: TONESEQ_H */
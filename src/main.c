@@ -1,6 +1,7 @@
 #include "board.h"
 #include "config/FreeRTOSConfig.h"
 #include "driver/crc.h"
+#include "driver/i2c.h"
 #include "driver/system.h"
 #include "driver/systick.h"
 #include "driver/uart.h"
@@ -17,6 +18,7 @@ void Main(void) {
   BOARD_ADC_Init();
   CRC_Init();
   UART_Init();
+  I2C_Init();
 
   Log("s0v4");
 
@@ -18,11 +18,14 @@
 #include "helper/bands.h"
 #include "helper/battery.h"
 #include "helper/channels.h"
+#include "helper/latency.h"
 #include "helper/lootlist.h"
 #include "helper/measurements.h"
+#include "helper/toneseq.h"
 #include "misc.h"
 #include "scheduler.h"
 #include "settings.h"
+#include "svc.h"
 #include "ui/spectrum.h"
 #include "ui/statusline.h"
 #include <stdint.h>
@@ -147,7 +150,7 @@ static void loadVFO(uint8_t num) {
 }
 
 static void saveVFO(uint8_t num) {
-  CHANNELS_Save(CHANNELS_GetCountMax() - 2 + num, &gVFO[num]);
+  CHANNELS_SaveHot(CHANNELS_GetCountMax() - 2 + num, &gVFO[num]);
 }
 
 static uint8_t indexOfMod(const ModulationType *arr, uint8_t n,
@@ -247,6 +250,10 @@ static void setSI4732Modulation(ModulationType mod) {
 static StaticTimer_t saveCurrentVfoTimerBuffer;
 static TimerHandle_t saveCurrentVfoTimer;
 
+static void saveCurrentVfoTimerCallback(TimerHandle_t t) {
+  SVC_Defer(RADIO_SaveCurrentVFO); // EEPROM waits on I2C, not in timer task
+}
+
 
 void RADIO_SaveCurrentVFODelayed(void) {
   /* Log("!!!VFO SAV delayed");
@@ -256,7 +263,8 @@ void RADIO_SaveCurrentVFODelayed(void) {
   }
   saveCurrentVfoTimer =
       xTimerCreateStatic("RS", pdMS_TO_TICKS(1000), pdFALSE, NULL,
-                         RADIO_SaveCurrentVFO, &saveCurrentVfoTimerBuffer);
+                         saveCurrentVfoTimerCallback,
+                         &saveCurrentVfoTimerBuffer);
   xTimerStart(saveCurrentVfoTimer, 0);
 }
 
@@ -346,21 +354,28 @@ static uint8_t calculateOutputPower(uint32_t f) {
   return power_bias;
 }
 
-static void sendEOT() {
-  BK4819_ExitSubAu();
+static const uint16_t ROGER_MOTO[] = {1540, 80, 0, 80, 1310, 80, 0, 0};
+static const uint16_t ROGER_TINY[] = {1250, 30, 0, 50, 1500, 30, 750, 30, 0, 0};
+static const uint16_t ROGER_STALK1[] = {
+    1975, 80, 0, 10, 2100, 100, 0, 10, 3140, 80, 0, 10, 2800, 100, 0, 10, 0, 0};
+
+// roger beep is on air, tx goes off when it is over
+static volatile bool txTailPending;
+
+static const uint16_t *rogerProgram(void) {
   switch (gSettings.roger) {
   case 1:
-    BK4819_PlayRoger();
-    break;
+    return ROGER_MOTO;
   case 2:
-    BK4819_PlayRogerTiny();
-    break;
+    return ROGER_TINY;
   case 3:
-    BK4819_PlayRogerStalk1();
-    break;
+    return ROGER_STALK1;
   default:
-    break;
+    return NULL;
   }
+}
+
+static void sendSTE() {
   if (gSettings.ste) {
     SYS_DelayMs(50);
     BK4819_GenTail(4);
@@ -430,6 +445,9 @@ void RADIO_ToggleRX(bool on) {
   if (gIsListening == on) {
     return;
   }
+  if (on) {
+    LAT_Mark(LAT_P_SQL); // before Log, which blocks on UART
+  }
   BOARD_ToggleGreen(on);
   Log("TOGGLE RX=%u", on);
   gRedrawScreen = true;
@@ -452,6 +470,9 @@ void RADIO_ToggleRX(bool on) {
   } else {
     toggleBK1080SI4732(on);
   }
+  if (on) {
+    LAT_Mark(LAT_P_AUDIO);
+  }
 }
 
 void RADIO_EnableCxCSS(void) {
@@ -521,12 +542,62 @@ void RADIO_ToggleTX(bool on) {
 
 bool RADIO_IsChMode() { return radio->channel >= 0; }
 
+static void txOff(void) {
+  gTxState = TX_UNKNOWN;
+
+  sendSTE();
+  toggleBK1080SI4732(false);
+  BOARD_ToggleRed(false);
+  BK4819_TurnsOffTones_TurnsOnRX();
+
+  gCurrentTxPower = 0;
+  BK4819_SetupPowerAmplifier(0, 0);
+  BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, false);
+  BK4819_ToggleGpioOut(BK4819_GPIO0_PIN28_RX_ENABLE, true);
+
+  setupToneDetection();
+  BK4819_TuneTo(radio->rxF, true);
+}
+
+// runs in app update task when beep ends, or in caller when keyed again
+static void rogerDone(void) {
+  taskENTER_CRITICAL();
+  const bool pending = txTailPending;
+  txTailPending = false;
+  taskEXIT_CRITICAL();
+  if (pending) {
+    txOff();
+  }
+}
+
 void RADIO_ToggleTXEX(bool on, uint32_t txF, uint8_t power, bool paEnabled) {
+  if (txTailPending) {
+    if (!on) {
+      return;
+    }
+    TONESEQ_Stop();
+    rogerDone();
+  }
+
   bool lastOn = gTxState == TX_ON;
   if (gTxState == on) {
     return;
   }
 
+  if (!on && lastOn) {
+    BK4819_ExitDTMF_TX(true); // also prepares to tx ste
+    BK4819_ExitSubAu();
+
+    const uint16_t *roger = rogerProgram();
+    if (roger) {
+      txTailPending = true;
+      TONESEQ_Play(roger, rogerDone);
+    } else {
+      txOff();
+    }
+    return;
+  }
+
   gTxState = on ? RADIO_GetTXState(txF) : TX_UNKNOWN;
 
   if (gTxState == TX_ON) {
@@ -547,26 +618,18 @@ void RADIO_ToggleTXEX(bool on, uint32_t txF, uint8_t power, bool paEnabled) {
     SYS_DelayMs(10);
 
     RADIO_EnableCxCSS();
+  }
+}
 
-  } else if (lastOn) {
-    BK4819_ExitDTMF_TX(true); // also prepares to tx ste
-
-    sendEOT();
-    toggleBK1080SI4732(false);
-    BOARD_ToggleRed(false);
-    BK4819_TurnsOffTones_TurnsOnRX();
-
-    gCurrentTxPower = 0;
-    BK4819_SetupPowerAmplifier(0, 0);
-    BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, false);
-    BK4819_ToggleGpioOut(BK4819_GPIO0_PIN28_RX_ENABLE, true);
-
-    setupToneDetection();
-    BK4819_TuneTo(radio->rxF, true);
+// tune from app: user takes radio over, scan service stops
+static void claimRadio(void) {
+  if (!SVC_InTask()) {
+    SVC_StopRadio();
   }
 }
 
 void RADIO_TuneToPure(uint32_t f, bool precise) {
+  claimRadio();
   uint32_t s = 100; // 1kHz
   if (f < SI47XX_F_MAX) {
     s = 50; // 500Hz
@@ -574,6 +637,7 @@ void RADIO_TuneToPure(uint32_t f, bool precise) {
     s = 1000; // 10kHz
   }
   f += gCurrentBand.ppm * s;
+  LAT_Mark(LAT_P_TUNE);
   LOOT_Replace(&gLoot[gSettings.activeVFO], f);
   Radio r = RADIO_GetRadio();
   // Log("Tune %s to %u", radioNames[r], f);
@@ -615,6 +679,7 @@ static void checkVisibleBand() {
 
 void RADIO_SetupByCurrentVFO(void) {
   Log("RADIO setup by VFO");
+  claimRadio();
   checkVisibleBand();
 
   RADIO_SwitchRadio();
@@ -651,10 +716,10 @@ void RADIO_SaveCurrentVFO(void) {
     VFO oldVfo;
     CHANNELS_Load(vfoChNum, &oldVfo);
     oldVfo.channel = chToSave;
-    CHANNELS_Save(vfoChNum, &oldVfo);
+    CHANNELS_SaveHot(vfoChNum, &oldVfo);
     return;
   }
-  CHANNELS_Save(vfoChNum, radio);
+  CHANNELS_SaveHot(vfoChNum, radio);
 }
 
 void RADIO_LoadCurrentVFO(void) {
@@ -768,7 +833,7 @@ void RADIO_Setup() {
   }
 }
 
-uint16_t RADIO_GetRSSI(void) {
+static uint16_t getRSSI(void) {
   switch (RADIO_GetRadio()) {
   case RADIO_BK4819:
     return BK4819_GetRSSI();
@@ -785,6 +850,14 @@ uint16_t RADIO_GetRSSI(void) {
   }
 }
 
+uint16_t RADIO_GetRSSI(void) {
+  const uint16_t rssi = getRSSI();
+  if (rssi) {
+    LAT_Mark(LAT_P_RSSI);
+  }
+  return rssi;
+}
+
 uint8_t RADIO_GetSNR(void) {
   switch (RADIO_GetRadio()) {
   case RADIO_BK4819:
@@ -965,6 +1038,8 @@ void RADIO_ToggleModulation(void) { RADIO_ToggleModulationEx(true); }
 
 bool RADIO_HasSi() { return BK1080_ReadRegister(1) != 0x1080; }
 
+static void dtmfDone(void) { RADIO_ToggleTX(false); }
+
 void RADIO_SendDTMF(const char *pattern, ...) {
   char str[32] = {0};
   va_list args;
@@ -973,10 +1048,8 @@ void RADIO_SendDTMF(const char *pattern, ...) {
   va_end(args);
   RADIO_ToggleTX(true);
   if (gTxState == TX_ON) {
-    SYS_DelayMs(200);
     BK4819_EnterDTMF_TX(true);
-    BK4819_PlayDTMFString(str, true, 100, 100, 100, 100);
-    RADIO_ToggleTX(false);
+    TONESEQ_PlayDTMF(str, 200, 100, 100, dtmfDone);
   }
 }
 
@@ -988,7 +1061,12 @@ void RADIO_GetGainString(char *String, uint8_t i) {
   }
 }
 
+// from app update it does nothing while a radio service owns radio
 void RADIO_CheckAndListen() {
+  const bool fromApp = !SVC_InTask();
+  if (fromApp && !SVC_RadioTake()) {
+    return;
+  }
   Measurement m = {
       .f = radio->rxF,
       .rssi = RADIO_GetRSSI(),
@@ -996,6 +1074,7 @@ void RADIO_CheckAndListen() {
       .noise = BK4819_GetNoise(),
       .glitch = BK4819_GetGlitch(),
   };
+  m.timeUs = LAT_SinceTuneUs();
   m.open = RADIO_IsSquelchOpen();
   if (!gMonitorMode) {
     LOOT_Update(&m);
@@ -1006,6 +1085,10 @@ void RADIO_CheckAndListen() {
   
   // 新增：更新自动回复状态
   RADIO_AutoReplyUpdate();
+
+  if (fromApp) {
+    SVC_RadioGive();
+  }
 }
 
 // 新增：自动回复功能实现
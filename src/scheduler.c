@@ -1,7 +1,29 @@
 #include "scheduler.h"
+#include "external/CMSIS_5/Device/ARM/ARMCM0/Include/ARMCM0.h"
+
+#define US_PER_TICK (1000000U / configTICK_RATE_HZ)
+// SysTick counts to us as (counts * K) >> 16, M0 has no divider
+#define COUNTS_TO_US_K                                                         \
+  ((65536000U + configCPU_CLOCK_HZ / 1000U - 1) / (configCPU_CLOCK_HZ / 1000U))
 
 uint32_t Now(void) { return pdTICKS_TO_MS(xTaskGetTickCount()); }
 
+// wraps every ~71 min, use differences only; not from ISR or critical section
+uint32_t NowUs(void) {
+  TickType_t t;
+  uint32_t v;
+  do {
+    t = xTaskGetTickCount();
+    v = SysTick->VAL;
+  } while (t != xTaskGetTickCount());
+  // rounded-up scale may reach next tick at counter end, keep it below
+  uint32_t sub = ((SysTick->LOAD - v) * COUNTS_TO_US_K) >> 16;
+  if (sub >= US_PER_TICK) {
+    sub = US_PER_TICK - 1;
+  }
+  return t * US_PER_TICK + sub;
+}
+
 void SetTimeout(uint32_t *v, uint32_t t) {
   *v = t == UINT32_MAX ? UINT32_MAX : Now() + t;
 }
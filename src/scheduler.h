@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 uint32_t Now(void);
+uint32_t NowUs(void);
 
 void SetTimeout(uint32_t *v, uint32_t t);
 bool CheckTimeout(uint32_t *v);
@@ -1,9 +1,11 @@
 #include "settings.h"
 #include "driver/bk4819.h"
 #include "driver/eeprom.h"
+#include "helper/nvring.h"
 #include "external/FreeRTOS/include/FreeRTOS.h"
 #include "external/FreeRTOS/include/projdefs.h"
 #include "external/FreeRTOS/include/timers.h"
+#include "svc.h"
 #include <string.h>
 
 uint8_t BL_TIME_VALUES[7] = {0, 5, 10, 20, 60, 120, 255};
@@ -85,23 +87,44 @@ const uint16_t PAGE_SIZES[6] = {
     32, 64, 64, 128, 128, 256,
 };
 
+// type stored at SETTINGS_OFFSET, ring location depends on it
+static EEPROMType homeEepromType = EEPROM_UNKNOWN;
+
 void SETTINGS_Save(void) {
+  if (NVRING_IsAvailable()) {
+    if (gSettings.eepromType == homeEepromType &&
+        NVRING_Write(NVRING_KEY_SETTINGS, &gSettings, SETTINGS_SIZE)) {
+      return;
+    }
+    NVRING_Sync();
+    NVRING_Disable();
+  }
   EEPROM_WriteBuffer(SETTINGS_OFFSET, &gSettings, SETTINGS_SIZE);
+  homeEepromType = gSettings.eepromType;
 }
 
 void SETTINGS_Load(void) {
   EEPROM_ReadBuffer(SETTINGS_OFFSET, &gSettings, SETTINGS_SIZE);
+  homeEepromType = gSettings.eepromType;
+  if (gSettings.eepromType < EEPROM_UNKNOWN) {
+    NVRING_Init();
+    NVRING_Read(NVRING_KEY_SETTINGS, 0, &gSettings, SETTINGS_SIZE);
+  }
 }
 
 static StaticTimer_t settingsSaveTimerBuffer;
 static TimerHandle_t settingsSaveTimer;
+static void settingsSaveTimerCallback(TimerHandle_t t) {
+  SVC_Defer(SETTINGS_Save); // EEPROM waits on I2C, not in timer task
+}
+
 void SETTINGS_DelayedSave(void) {
   if (settingsSaveTimer) {
     xTimerStop(settingsSaveTimer, 0);
   }
   settingsSaveTimer =
       xTimerCreateStatic("SS", pdMS_TO_TICKS(1000), pdFALSE, NULL,
-                         SETTINGS_Save, &settingsSaveTimerBuffer);
+                         settingsSaveTimerCallback, &settingsSaveTimerBuffer);
   xTimerStart(settingsSaveTimer, 0);
 }
 
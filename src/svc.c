@@ -0,0 +1,218 @@
+#include "svc.h"
+#include "apps/bcscan.h"
+#include "apps/chscan.h"
+#include "apps/fc.h"
+#include "driver/uart.h"
+#include "external/FreeRTOS/include/FreeRTOS.h"
+#include "external/FreeRTOS/include/queue.h"
+#include "external/FreeRTOS/include/semphr.h"
+#include "external/FreeRTOS/include/task.h"
+#include "helper/rds.h"
+
+// Background services, run by boot stage task once boot is done, so scans
+// go on while any app is on screen. Each update returns time to sleep, task
+// wakes for earliest due service or on start/stop. Load is share of time
+// spent in update over last LOAD_WINDOW_MS. Deferred jobs are EEPROM saves
+// from timer callbacks, run here so timer task never waits for I2C.
+
+#define LOAD_WINDOW_MS 1000
+#define JOBS_LEN 4
+
+static const Service services[SVC_COUNT] = {
+    [SVC_SCAN] = {"SCAN", CHSCAN_svcInit, CHSCAN_svcUpdate, NULL, 1, true},
+    [SVC_FC] = {"FC", FC_svcInit, FC_svcUpdate, FC_svcDeinit, 0, true},
+    [SVC_BCSCAN] = {"BC", BCSCAN_svcInit, BCSCAN_svcUpdate, BCSCAN_svcDeinit,
+                    1, true},
+    [SVC_RDS] = {"RDS", RDS_svcInit, RDS_svcUpdate, NULL, 2, false},
+};
+
+static volatile bool running[SVC_COUNT];
+static TickType_t dueAt[SVC_COUNT];
+static TickType_t busy[SVC_COUNT];
+static uint8_t load[SVC_COUNT];
+static TickType_t windowStart;
+
+static TaskHandle_t task;
+static StaticSemaphore_t mutexBuffer;
+static SemaphoreHandle_t mutex;
+
+static QueueHandle_t jobs;
+static StaticQueue_t jobsBuffer;
+static uint8_t jobsStorage[JOBS_LEN * sizeof(SvcJob)];
+
+void SVC_Init(TaskHandle_t t) {
+  task = t;
+  mutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
+  jobs = xQueueCreateStatic(JOBS_LEN, sizeof(SvcJob), jobsStorage, &jobsBuffer);
+}
+
+// never blocks, for timer callbacks; jobs must not mind a dropped call
+void SVC_Defer(SvcJob job) {
+  if (xQueueSend(jobs, &job, 0) != pdPASS) {
+    Log("SVC jobs full");
+  }
+  xTaskNotifyGive(task);
+}
+
+static void runJobs(void) {
+  SvcJob job;
+  while (xQueueReceive(jobs, &job, 0) == pdPASS) {
+    job();
+  }
+}
+
+static int8_t nextDue(TickType_t now) {
+  int8_t best = -1;
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    if (!running[i] || (int32_t)(dueAt[i] - now) > 0) {
+      continue;
+    }
+    if (best < 0 || services[i].priority < services[best].priority) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+static TickType_t timeToNext(TickType_t now) {
+  TickType_t wait = pdMS_TO_TICKS(LOAD_WINDOW_MS);
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    if (!running[i]) {
+      continue;
+    }
+    const int32_t left = dueAt[i] - now;
+    if (left <= 0) {
+      return 0;
+    }
+    if ((TickType_t)left < wait) {
+      wait = left;
+    }
+  }
+  return wait;
+}
+
+static void updateLoad(TickType_t now) {
+  const TickType_t elapsed = now - windowStart;
+  if (elapsed < pdMS_TO_TICKS(LOAD_WINDOW_MS)) {
+    return;
+  }
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    load[i] = busy[i] * 100 / elapsed;
+    busy[i] = 0;
+  }
+  windowStart = now;
+}
+
+void SVC_Loop(void) {
+  windowStart = xTaskGetTickCount();
+  for (;;) {
+    runJobs();
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const int8_t i = nextDue(xTaskGetTickCount());
+    if (i >= 0) {
+      const TickType_t t = xTaskGetTickCount();
+      const uint16_t ms = services[i].update();
+      const TickType_t now = xTaskGetTickCount();
+      busy[i] += now - t;
+      dueAt[i] = now + pdMS_TO_TICKS(ms);
+    }
+    const TickType_t now = xTaskGetTickCount();
+    updateLoad(now);
+    const TickType_t wait = timeToNext(now);
+    xSemaphoreGive(mutex);
+
+    if (wait) {
+      ulTaskNotifyTake(pdTRUE, wait);
+    }
+  }
+}
+
+static void stop(Svc svc) {
+  if (!running[svc]) {
+    return;
+  }
+  running[svc] = false;
+  if (services[svc].deinit) {
+    services[svc].deinit();
+  }
+  load[svc] = 0;
+  Log("SVC %s off", services[svc].name);
+}
+
+void SVC_Start(Svc svc) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (!running[svc]) {
+    for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+      if (services[svc].radio && services[i].radio) {
+        stop(i);
+      }
+    }
+    if (services[svc].init) {
+      services[svc].init();
+    }
+    dueAt[svc] = xTaskGetTickCount();
+    busy[svc] = 0;
+    running[svc] = true;
+    Log("SVC %s on", services[svc].name);
+  }
+  xSemaphoreGive(mutex);
+  xTaskNotifyGive(task);
+}
+
+void SVC_Stop(Svc svc) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  stop(svc);
+  xSemaphoreGive(mutex);
+}
+
+void SVC_Toggle(Svc svc, bool on) {
+  if (on) {
+    SVC_Start(svc);
+  } else {
+    SVC_Stop(svc);
+  }
+}
+
+void SVC_StopRadio(void) {
+  if (!SVC_RadioBusy()) {
+    return; // also keeps deinit tuning back from taking mutex again
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    if (services[i].radio) {
+      stop(i);
+    }
+  }
+  xSemaphoreGive(mutex);
+}
+
+bool SVC_Running(Svc svc) { return running[svc]; }
+
+bool SVC_RadioBusy(void) {
+  for (uint8_t i = 0; i < SVC_COUNT; ++i) {
+    if (running[i] && services[i].radio) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SVC_InTask(void) { return xTaskGetCurrentTaskHandle() == task; }
+
+// Radio work from app tasks: false while a radio service owns radio. On true
+// no service update runs until SVC_RadioGive.
+bool SVC_RadioTake(void) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (SVC_RadioBusy()) {
+    xSemaphoreGive(mutex);
+    return false;
+  }
+  return true;
+}
+
+void SVC_RadioGive(void) { xSemaphoreGive(mutex); }
+
+uint8_t SVC_GetLoad(Svc svc) { return load[svc]; }
+
+const char *SVC_GetName(Svc svc) { return services[svc].name; }
@@ -0,0 +1,43 @@
+#ifndef SVC_H
+#define SVC_H
+
+#include "external/FreeRTOS/include/FreeRTOS.h"
+#include "external/FreeRTOS/include/task.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  SVC_SCAN,
+  SVC_FC,
+  SVC_BCSCAN,
+  SVC_RDS,
+  SVC_COUNT,
+} Svc;
+
+typedef struct {
+  const char *name;
+  void (*init)(void);
+  uint16_t (*update)(void); // ms until next call
+  void (*deinit)(void);
+  uint8_t priority; // lower runs first when several are due
+  bool radio;       // retunes radio, only one such service at a time
+} Service;
+
+typedef void (*SvcJob)(void);
+
+void SVC_Init(TaskHandle_t task);
+void SVC_Loop(void);
+void SVC_Defer(SvcJob job);
+void SVC_Start(Svc svc);
+void SVC_Stop(Svc svc);
+void SVC_Toggle(Svc svc, bool on);
+void SVC_StopRadio(void);
+bool SVC_Running(Svc svc);
+bool SVC_RadioBusy(void);
+bool SVC_InTask(void);
+bool SVC_RadioTake(void);
+void SVC_RadioGive(void);
+uint8_t SVC_GetLoad(Svc svc);
+const char *SVC_GetName(Svc svc);
+
+#endif /* end of include guard: SVC_H */
@@ -11,15 +11,22 @@
 #include "external/FreeRTOS/include/FreeRTOS.h"
 #include "external/FreeRTOS/include/projdefs.h"
 #include "external/FreeRTOS/include/queue.h"
+#include "external/FreeRTOS/include/semphr.h"
 #include "external/FreeRTOS/include/task.h"
 #include "external/FreeRTOS/include/timers.h"
 #include "external/FreeRTOS/portable/GCC/ARM_CM0/portmacro.h"
 #include "helper/bands.h"
 #include "helper/battery.h"
+#include "helper/latency.h"
+#include "helper/lootjournal.h"
+#include "helper/lootlist.h"
+#include "helper/probe.h"
+#include "helper/toneseq.h"
 #include "misc.h"
 #include "radio.h"
 #include "scheduler.h"
 #include "settings.h"
+#include "svc.h"
 #include "ui/graphics.h"
 #include "ui/statusline.h"
 
@@ -47,6 +54,15 @@ static uint8_t DEAD_BUF[] = {0xDE, 0xAD};
 
 uint32_t gAppUpdateInterval = pdMS_TO_TICKS(1);
 
+uint16_t gBootMs[BOOT_STAGE_COUNT];
+const char *bootStageNames[BOOT_STAGE_COUNT] = {
+    [BOOT_SETTINGS] = "SET", //
+    [BOOT_LCD] = "LCD",      //
+    [BOOT_BANDS] = "BAND",   //
+    [BOOT_RADIO] = "RADIO",  //
+    [BOOT_APP] = "APP",      //
+};
+
 static char notificationMessage[16] = "";
 static uint32_t notificationTimeoutAt;
 
@@ -59,22 +75,45 @@ static uint8_t systemQueueStorageArea[queueLen * itemSize];
 
 StaticTask_t appUpdateTaskBuffer;
 StackType_t appUpdateTaskStack[configMINIMAL_STACK_SIZE + 100];
+static TaskHandle_t appUpdateTask;
 
 StaticTask_t appRenderTaskBuffer;
 StackType_t appRenderTaskStack[configMINIMAL_STACK_SIZE + 100];
+static TaskHandle_t appRenderTask;
+
+static StaticTask_t bootStageTaskBuffer;
+// also runs jobs deferred from timer task, so at least its depth
+static StackType_t bootStageTaskStack[configTIMER_TASK_STACK_DEPTH];
+static TaskHandle_t bootStageTask;
+
+static StaticSemaphore_t bootStageDoneBuffer;
+static SemaphoreHandle_t bootStageDone;
+
+// own semaphore, task notification of boot task belongs to services
+static StaticSemaphore_t settingsReadyBuffer;
+static SemaphoreHandle_t settingsReady;
+static bool bootInitRadio;
 
 static uint32_t lastUartDataTime;
 
 static void appUpdate(void *arg) {
   for (;;) {
-    APPS_update();
-    vTaskDelay(gAppUpdateInterval);
+    if (!PROBE_Update()) {
+      APPS_update();
+    }
+    UART_TxPump();
+    // tone sequence timer wakes it early for next step
+    ulTaskNotifyTake(pdTRUE, gAppUpdateInterval);
+    TONESEQ_Update();
   }
 }
 
 static void appRender(void *arg) {
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // display is up
+
   for (;;) {
     if (gRedrawScreen) {
+      const uint32_t t = NowUs();
       UI_ClearScreen();
 
       APPS_render();
@@ -87,15 +126,17 @@ static void appRender(void *arg) {
       STATUSLINE_render(); // coz of APPS_render calls STATUSLINE_SetText
 
       ST7565_Blit();
+      LAT_Add(LAT_RENDER, NowUs() - t);
       gRedrawScreen = false;
     }
+    UART_MirrorScreen(); // also retries pages deferred on full TX queue
     vTaskDelay(pdMS_TO_TICKS(40)); // 25 fps
   }
 }
 
 static void systemUpdate() {
-  BATTERY_UpdateBatteryInfo();
   BACKLIGHT_Update();
+  SVC_Defer(LOOT_Age); // loot lock may be held by journal flush
 }
 
 static bool resetNeeded() {
@@ -115,47 +156,98 @@ static void loadSettingsOrReset() {
   }
 }
 
+static void bootMark(BootStage stage) { gBootMs[stage] = Now(); }
+
+static void logBootProfile(void) {
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; ++i) {
+    Log("BOOT %s %ums", bootStageNames[i], gBootMs[i]);
+  }
+}
+
+// Runs beside sys task while it loads settings and bands. Display power-up
+// mostly sleeps; BK4819 has own bus, BK1080/SI47XX access is behind I2C lock.
+// Then it stays as background services task, reusing its stack.
+static void bootStage(void *arg) {
+  ST7565_Init(true);
+
+  // settings loaded: contrast is known, radio init needed unless reset
+  xSemaphoreTake(settingsReady, portMAX_DELAY);
+  ST7565_Init(false);
+  bootMark(BOOT_LCD);
+  xTaskNotifyGive(appRenderTask);
+
+  if (bootInitRadio) {
+    RADIO_Init();
+    bootMark(BOOT_RADIO);
+  }
+
+  // board and radio are up now
+  SVC_Start(SVC_RDS); // idles unless SI4732 is on FM
+
+  xSemaphoreGive(bootStageDone);
+  SVC_Loop();
+}
+
 void SYS_Main(void *params) {
+  systemMessageQueue = xQueueCreateStatic(
+      queueLen, itemSize, systemQueueStorageArea, &systemTasksQueue);
+
+  bootStageDone = xSemaphoreCreateBinaryStatic(&bootStageDoneBuffer);
+  settingsReady = xSemaphoreCreateBinaryStatic(&settingsReadyBuffer);
+  bootStageTask = xTaskCreateStatic(
+      bootStage, "boot", ARRAY_SIZE(bootStageTaskStack), NULL, 1,
+      bootStageTaskStack, &bootStageTaskBuffer);
+  SVC_Init(bootStageTask);
+  LOOT_Init();
+
   BOARD_Init();
-  BATTERY_UpdateBatteryInfo();
 
   // run updates & render tasks to keep user informed
   sysTimer = xTimerCreateStatic("sysT", pdMS_TO_TICKS(1000), pdTRUE, NULL,
                                 systemUpdate, &sysTimerBuffer);
   xTimerStart(sysTimer, 0);
 
-  xTaskCreateStatic(appUpdate, "appU", ARRAY_SIZE(appUpdateTaskStack), NULL, 3,
-                    appUpdateTaskStack, &appUpdateTaskBuffer);
-  xTaskCreateStatic(appRender, "appR", ARRAY_SIZE(appRenderTaskStack), NULL, 2,
-                    appRenderTaskStack, &appRenderTaskBuffer);
+  appUpdateTask = xTaskCreateStatic(appUpdate, "appU",
+                                    ARRAY_SIZE(appUpdateTaskStack), NULL, 3,
+                                    appUpdateTaskStack, &appUpdateTaskBuffer);
+  TONESEQ_Init(appUpdateTask);
+  appRenderTask = xTaskCreateStatic(appRender, "appR",
+                                    ARRAY_SIZE(appRenderTaskStack), NULL, 2,
+                                    appRenderTaskStack, &appRenderTaskBuffer);
 
   if (resetNeeded()) {
     gSettings.batteryCalibration = 2000;
     gSettings.backlight = 5;
+    BATTERY_Init();
+    bootInitRadio = false;
+    xSemaphoreGive(settingsReady);
     APPS_run(APP_RESET);
   } else {
     loadSettingsOrReset();
-    BATTERY_UpdateBatteryInfo();
-
-    ST7565_Init(false);
+    bootMark(BOOT_SETTINGS);
+    bootInitRadio = true;
+    xSemaphoreGive(settingsReady);
+    BATTERY_Init();
     BACKLIGHT_Init();
 
     SYS_MsgNotify("LOAD BANDS", 1000);
     Log("LOAD BANDS");
     BANDS_Load();
 
+    LOOTJOURNAL_Init();
+    bootMark(BOOT_BANDS);
+
     SYS_MsgNotify("INIT RADIO", 1000);
-    Log("INIT RADIO");
-    RADIO_Init();
+    Log("WAIT RADIO");
+    xSemaphoreTake(bootStageDone, portMAX_DELAY);
     SYS_MsgNotify("", 0);
 
     Log("RUN DEFAULT APP");
     APPS_run(gSettings.mainApp);
+    bootMark(BOOT_APP);
+    logBootProfile();
   }
 
-  systemMessageQueue = xQueueCreateStatic(
-      queueLen, itemSize, systemQueueStorageArea, &systemTasksQueue);
-
   SystemMessages n;
 
   for (;;) {
@@ -207,6 +299,8 @@ void SYS_Main(void *params) {
       }
     }
 
+    UART_TxPump();
+
     while (UART_IsCommandAvailable()) {
       UART_HandleCommand();
       lastUartDataTime = Now();
@@ -2,7 +2,18 @@
 #define SYS_H
 #include "driver/keyboard.h"
 
+typedef enum {
+  BOOT_SETTINGS,
+  BOOT_LCD,
+  BOOT_BANDS,
+  BOOT_RADIO,
+  BOOT_APP,
+  BOOT_STAGE_COUNT,
+} BootStage;
+
 extern uint32_t gAppUpdateInterval;
+extern uint16_t gBootMs[BOOT_STAGE_COUNT]; // stage done, ms since start
+extern const char *bootStageNames[BOOT_STAGE_COUNT];
 
 void SYS_Main(void *params);
 void SYS_MsgKey(KEY_Code_t key, Key_State_t state);
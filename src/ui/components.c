@@ -61,8 +61,10 @@ void UI_RSSIBar(uint8_t y) {
 }
 
 void drawTicks(uint8_t y, uint32_t fs, uint32_t fe, uint32_t div, uint8_t h) {
+  DomainMapF map;
+  DomainMapF_Init(&map, fs, fe, LCD_WIDTH - 1);
   for (uint32_t f = fs - (fs % div) + div; f < fe; f += div) {
-    uint8_t x = ConvertDomainF(f, fs, fe, 0, LCD_WIDTH - 1);
+    uint8_t x = DomainMapF_ToX(&map, f);
     DrawVLine(x, y, h, C_FILL);
   }
 }
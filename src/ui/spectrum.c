@@ -1,4 +1,5 @@
 #include "spectrum.h"
+#include "../apps/apps.h"
 #include "../driver/uart.h"
 #include "../helper/measurements.h"
 #include "components.h"
@@ -18,7 +19,14 @@ uint8_t SPECTRUM_H = 44;
 
 static uint8_t S_BOTTOM;
 
-static uint16_t rssiHistory[MAX_POINTS] = {0};
+typedef struct {
+  uint16_t rssi[MAX_POINTS];
+} SweepHistory;
+
+_Static_assert(sizeof(SweepHistory) <= APPS_ARENA_SIZE, "sweep history");
+
+// sweep history lives in spectrum app state, graph is used by VFO apps too
+static uint16_t *rssiHistory;
 static uint16_t rssiGraphHistory[MAX_POINTS] = {0};
 
 static uint8_t x = 0;
@@ -27,6 +35,11 @@ static uint8_t filledPoints;
 
 static Band *range;
 static uint32_t step;
+static DomainMapF fMap;
+// sweep steps are sequential: a step starts at x where previous one ended
+static uint32_t nextF;
+static uint8_t nextX;
+static bool nextValid;
 
 static uint16_t minRssi(const uint16_t *array, uint8_t n) {
   uint16_t min = UINT16_MAX;
@@ -58,6 +71,12 @@ void SP_ResetHistory(void) {
   }
 }
 
+void SP_Claim(void) {
+  SweepHistory *h = APPS_Claim(sizeof(SweepHistory));
+  rssiHistory = h->rssi;
+  filledPoints = 0;
+}
+
 void SP_Begin(void) {
   x = 0;
   ox = UINT8_MAX;
@@ -67,21 +86,83 @@ void SP_Init(Band *b) {
   S_BOTTOM = SPECTRUM_Y + SPECTRUM_H;
   range = b;
   step = StepFrequencyTable[b->step];
+  DomainMapF_Init(&fMap, b->rxF, b->txF, MAX_POINTS - 1);
+  nextValid = false;
   SP_ResetHistory();
   SP_Begin();
 }
 
-uint8_t SP_F2X(uint32_t f) {
-  return ConvertDomainF(f, range->rxF, range->txF, 0, MAX_POINTS - 1);
-}
+uint8_t SP_F2X(uint32_t f) { return DomainMapF_ToX(&fMap, f); }
+
+uint32_t SP_X2F(uint8_t x) { return DomainMapF_ToF(&fMap, x); }
+
+#ifdef DEBUG
+// on-target cycle counts, with mismatch count against ConvertDomainF over
+// current range for every step size (host test covers random ranges)
+void SP_Benchmark(void) {
+  if (!range) {
+    return;
+  }
+  const uint32_t cyclesPerTick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+  const uint16_t N = 2048;
+  const uint32_t fs = range->rxF;
+  const uint32_t fe = range->txF;
+  uint32_t mismatches = 0;
+  volatile uint32_t sink = 0;
+
+  for (uint8_t i = 0; i < ARRAY_SIZE(StepFrequencyTable); ++i) {
+    const uint32_t st = StepFrequencyTable[i];
+    for (uint32_t f = fs; f <= fe + st; f += st) {
+      if (SP_F2X(f) != ConvertDomainF(f, fs, fe, 0, MAX_POINTS - 1)) {
+        mismatches++;
+      }
+      if (f - fs > st * 4096) {
+        break;
+      }
+    }
+  }
+  for (uint8_t x = 0; x < MAX_POINTS; ++x) {
+    if (SP_X2F(x) != ConvertDomainF(x, 0, MAX_POINTS - 1, fs, fe)) {
+      mismatches++;
+    }
+  }
+
+  TickType_t t = xTaskGetTickCount();
+  for (uint16_t i = 0; i < N; ++i) {
+    sink += ConvertDomainF(fs + i * step, fs, fe, 0, MAX_POINTS - 1);
+  }
+  const uint32_t oldF2X = (xTaskGetTickCount() - t) * cyclesPerTick / N;
+
+  t = xTaskGetTickCount();
+  for (uint16_t i = 0; i < N; ++i) {
+    sink += SP_F2X(fs + i * step);
+  }
+  const uint32_t newF2X = (xTaskGetTickCount() - t) * cyclesPerTick / N;
+
+  t = xTaskGetTickCount();
+  for (uint16_t i = 0; i < N; ++i) {
+    sink += ConvertDomainF(i & (MAX_POINTS - 1), 0, MAX_POINTS - 1, fs, fe);
+  }
+  const uint32_t oldX2F = (xTaskGetTickCount() - t) * cyclesPerTick / N;
+
+  t = xTaskGetTickCount();
+  for (uint16_t i = 0; i < N; ++i) {
+    sink += SP_X2F(i & (MAX_POINTS - 1));
+  }
+  const uint32_t newX2F = (xTaskGetTickCount() - t) * cyclesPerTick / N;
 
-uint32_t SP_X2F(uint8_t x) {
-  return ConvertDomainF(x, 0, MAX_POINTS - 1, range->rxF, range->txF);
+  Log("SP map: mismatch=%u F2X %u->%u cyc, X2F %u->%u cyc", mismatches,
+      oldF2X, newF2X, oldX2F, newX2F);
 }
+#endif
 
 void SP_AddPoint(const Measurement *msm) {
-  uint32_t xs = SP_F2X(msm->f);
-  uint32_t xe = SP_F2X(msm->f + step);
+  const uint32_t fe = msm->f + step;
+  uint32_t xs = nextValid && msm->f == nextF ? nextX : SP_F2X(msm->f);
+  uint32_t xe = SP_F2X(fe);
+  nextF = fe;
+  nextX = xe;
+  nextValid = true;
 
   if (xe > MAX_POINTS) {
     xe = MAX_POINTS;
@@ -115,8 +196,6 @@ static VMinMax getV() {
   };
 }
 
-uint16_t peaks[MAX_POINTS];
-
 void SP_Render(const Band *p) {
   const VMinMax v = getV();
 
@@ -131,12 +210,6 @@ void SP_Render(const Band *p) {
     uint8_t yVal = ConvertDomain(rssiHistory[i], v.vMin, v.vMax, 0, SPECTRUM_H);
     DrawVLine(i, S_BOTTOM - yVal, yVal, C_FILL);
   }
-
-  for (uint8_t x = 0; x < MAX_POINTS; ++x) {
-    if (peaks[x]) {
-      DrawVLine(x, SPECTRUM_Y + 1, 4, C_FILL);
-    }
-  }
 }
 
 void SP_RenderArrow(const Band *p, uint32_t f) {
@@ -162,6 +235,13 @@ void SP_RenderLine(uint16_t rssi) {
   DrawHLine(0, S_BOTTOM - yVal, filledPoints, C_FILL);
 }
 
+// pushes finished sweep to UART when host asked for it
+void SP_Stream(void) {
+  if (UART_IsSpectrumStreaming()) {
+    UART_SendSpectrum(range->rxF, range->txF, step, rssiHistory, filledPoints);
+  }
+}
+
 uint16_t SP_GetNoiseFloor() { return Std(rssiHistory, filledPoints); }
 uint16_t SP_GetRssiMax() { return Max(rssiHistory, filledPoints); }
 
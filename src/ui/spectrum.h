@@ -8,8 +8,10 @@
 
 void SP_AddPoint(const Measurement *msm);
 void SP_ResetHistory();
+void SP_Claim(void);
 void SP_Init(Band *b);
 void SP_Begin();
+void SP_Stream(void);
 void SP_Render(const Band *p);
 void SP_RenderRssi(uint16_t rssi, char *text, bool top);
 void SP_RenderLine(uint16_t rssi);
@@ -23,6 +25,10 @@ void SP_Shift(int16_t n);
 void SP_ShiftGraph(int16_t n);
 
 uint8_t SP_F2X(uint32_t f);
+uint32_t SP_X2F(uint8_t x);
+#ifdef DEBUG
+void SP_Benchmark(void);
+#endif
 
 void CUR_Render();
 bool CUR_Move(bool up);
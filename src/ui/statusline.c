@@ -11,6 +11,7 @@
 #include "../helper/channels.h"
 #include "../helper/numnav.h"
 #include "../scheduler.h"
+#include "../svc.h"
 #include "components.h"
 #include "graphics.h"
 #include <string.h>
@@ -52,7 +53,6 @@ void STATUSLINE_SetTickerText(const char *pattern, ...) {
 }
 
 void STATUSLINE_update(void) {
-  BATTERY_UpdateBatteryInfo();
   uint8_t level = gBatteryPercent / 10;
   if (gBatteryPercent < BAT_WARN_PERCENT) {
     showBattery = !showBattery;
@@ -100,7 +100,7 @@ void STATUSLINE_render(void) {
                  gBatteryVoltage / 100, gBatteryVoltage % 100);
   }
 
-  char icons[8] = {'\0'};
+  char icons[10] = {'\0'};
   uint8_t idx = 0;
 
   if (gEepromWrite) {
@@ -115,13 +115,13 @@ void STATUSLINE_render(void) {
     icons[idx++] = SYM_DW;
   }
 
-  /* if (SVC_Running(SVC_FC)) {
+  if (SVC_Running(SVC_FC)) {
     icons[idx++] = SYM_FC;
   }
 
-  if (SVC_Running(SVC_SCAN)) {
+  if (SVC_Running(SVC_SCAN) || SVC_Running(SVC_BCSCAN)) {
     icons[idx++] = SYM_SCAN;
-  } */
+  }
 
   if (LOOT_Size() == LOOT_SIZE_MAX) {
     icons[idx++] = SYM_LOOT_FULL;
@@ -165,8 +165,8 @@ void STATUSLINE_renderCurrentBand() {
     } else {
       if (gCurrentBand.meta.type == TYPE_BAND_DETACHED) {
         STATUSLINE_SetText("*%s", gCurrentBand.name);
-        /* } else if (SVC_Running(SVC_SCAN)) {
-          STATUSLINE_SetText("=%s", gCurrentBand.name); */
+      } else if (SVC_Running(SVC_SCAN)) {
+        STATUSLINE_SetText("=%s", gCurrentBand.name);
       } else {
         STATUSLINE_SetText(radio->fixedBoundsMode ? "=%s:%u" : "%s:%u",
                            gCurrentBand.name,
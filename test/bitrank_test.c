@@ -0,0 +1,61 @@
+#include "../src/helper/bitrank.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Host test: BITRANK_Select/Rank against naive scan over random bitsets.
+
+#define WORDS 32 // SCANLIST_MAX / 32
+
+static uint32_t bits[WORDS];
+static uint16_t rank[WORDS];
+
+static int fails;
+
+static void check(int cond, const char *what, unsigned a, unsigned b) {
+  if (!cond && fails++ < 10) {
+    printf("FAIL %s %u %u\n", what, a, b);
+  }
+}
+
+static void run(unsigned density) {
+  for (int w = 0; w < WORDS; ++w) {
+    bits[w] = 0;
+    for (int b = 0; b < 32; ++b) {
+      if ((unsigned)rand() % 100 < density) {
+        bits[w] |= 1UL << b;
+      }
+    }
+  }
+  const uint16_t n = BITRANK_Build(bits, rank, WORDS);
+
+  uint16_t seen = 0;
+  for (uint16_t pos = 0; pos < WORDS * 32; ++pos) {
+    const int set = (bits[pos / 32] >> (pos % 32)) & 1;
+    const int16_t r = BITRANK_Rank(bits, rank, WORDS, pos);
+    if (set) {
+      check(r == seen, "rank", pos, r);
+      check(BITRANK_Select(bits, rank, WORDS, seen) == pos, "select", seen,
+            pos);
+      seen++;
+    } else {
+      check(r == -1, "rank clear", pos, r);
+    }
+  }
+  check(seen == n, "count", seen, n);
+
+  // out of range gives sentinel instead of spinning
+  check(BITRANK_Select(bits, rank, WORDS, n) == WORDS * 32, "sentinel", n, 0);
+  check(BITRANK_Select(bits, rank, WORDS, 0xFFFF) == WORDS * 32, "sentinel",
+        0xFFFF, 0);
+  check(BITRANK_Rank(bits, rank, WORDS, WORDS * 32) == -1, "rank end", 0, 0);
+}
+
+int main(void) {
+  srand(1);
+  const unsigned densities[] = {0, 1, 10, 50, 90, 100};
+  for (int i = 0; i < 200; ++i) {
+    run(densities[i % 6]);
+  }
+  printf("bitrank: %s\n", fails ? "FAIL" : "ok");
+  return fails != 0;
+}
@@ -0,0 +1,103 @@
+#include "../src/dcs.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Host test: table based DCS/CTCSS decoders against the former search code.
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+static uint32_t refGolay(uint32_t CodeWord) {
+  uint32_t Word = CodeWord;
+  for (unsigned int i = 0; i < 12; i++) {
+    Word <<= 1;
+    if (Word & 0x1000)
+      Word ^= 0x08EA;
+  }
+  return CodeWord | ((Word & 0x0FFE) << 11);
+}
+
+static uint32_t refCodeWord(DCS_CodeType_t CodeType, uint8_t Option) {
+  uint32_t Code = refGolay(DCS_Options[Option] + 0x800U);
+  if (CodeType == CODE_TYPE_REVERSE_DIGITAL)
+    Code ^= 0x7FFFFF;
+  return Code;
+}
+
+static uint8_t refCdcss(uint32_t Code) {
+  for (unsigned int i = 0; i < 23; i++) {
+    if (((Code >> 9) & 0x7U) == 4) {
+      for (unsigned int j = 0; j < ARRAY_SIZE(DCS_Options); j++)
+        if (DCS_Options[j] == (Code & 0x1FF) &&
+            refCodeWord(CODE_TYPE_DIGITAL, j) == Code)
+          return j;
+    }
+    uint32_t Shift = Code >> 1;
+    if (Code & 1U)
+      Shift |= 0x400000U;
+    Code = Shift;
+  }
+  return 0xFF;
+}
+
+static uint8_t refCtcss(uint16_t Code) {
+  uint8_t Result = 0xFF;
+  int Smallest = ARRAY_SIZE(CTCSS_Options);
+  for (unsigned int i = 0; i < ARRAY_SIZE(CTCSS_Options); i++) {
+    int Delta = Code - CTCSS_Options[i];
+    if (Delta < 0)
+      Delta = -Delta;
+    if (Smallest > Delta) {
+      Smallest = Delta;
+      Result = i;
+    }
+  }
+  return Result;
+}
+
+static int fails;
+
+static void check(int cond, const char *what, unsigned a, unsigned b,
+                  unsigned c) {
+  if (!cond && fails++ < 10) {
+    printf("FAIL %s %X %u %u\n", what, a, b, c);
+  }
+}
+
+static uint32_t rotate(uint32_t Code, unsigned n) {
+  return ((Code << n) | (Code >> (23 - n))) & 0x7FFFFF;
+}
+
+static void cdcss(uint32_t Code) {
+  const uint8_t got = DCS_GetCdcssCode(Code);
+  const uint8_t want = refCdcss(Code);
+  check(got == want, "cdcss", Code, got, want);
+}
+
+int main(void) {
+  for (uint8_t j = 0; j < ARRAY_SIZE(DCS_Options); ++j) {
+    for (DCS_CodeType_t t = CODE_TYPE_DIGITAL; t <= CODE_TYPE_REVERSE_DIGITAL;
+         ++t) {
+      const uint32_t w = refCodeWord(t, j);
+      check(DCS_GetGolayCodeWord(t, j) == w, "golay", w, j, t);
+      // every phase the receiver may catch the word in, plus 1-bit errors
+      for (unsigned n = 0; n < 23; ++n) {
+        cdcss(rotate(w, n));
+        cdcss(rotate(w, n) ^ (1UL << n));
+      }
+    }
+  }
+
+  srand(1);
+  for (int i = 0; i < 200000; ++i) {
+    cdcss((((uint32_t)rand() << 16) ^ (uint32_t)rand()) & 0x7FFFFF);
+  }
+
+  for (uint32_t c = 0; c <= 0xFFFF; ++c) {
+    const uint8_t got = DCS_GetCtcssCode(c);
+    const uint8_t want = refCtcss(c);
+    check(got == want, "ctcss", c, got, want);
+  }
+
+  printf("dcs: %s\n", fails ? "FAIL" : "ok");
+  return fails != 0;
+}
@@ -0,0 +1,59 @@
+#include "../src/helper/measurements.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Host test: DomainMapF_ToX/ToF must match ConvertDomainF bit for bit, for
+// sweeps over random ranges at every StepFrequencyTable step.
+
+static const uint16_t STEPS[] = {
+    2, 5, 50, 100, 250, 500, 625, 833, 900, 1000, 1250, 2500, 5000, 10000, 50000,
+};
+static const uint8_t X_MAX[] = {127, 63, 1, 255};
+
+static int fails;
+
+static uint32_t rnd32(void) {
+  return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+static void check(int cond, const char *what, uint32_t a, uint32_t b,
+                  uint32_t c) {
+  if (!cond && fails++ < 10) {
+    printf("FAIL %s %u %u %u\n", what, a, b, c);
+  }
+}
+
+static void run(uint32_t fs, uint32_t fe, uint8_t xMax) {
+  DomainMapF map;
+  DomainMapF_Init(&map, fs, fe, xMax);
+
+  for (unsigned i = 0; i < sizeof(STEPS) / sizeof(STEPS[0]); ++i) {
+    const uint32_t st = STEPS[i];
+    // sweep from just below start to past end, as scan steps do
+    uint32_t f = fs > st ? fs - st : 0;
+    for (unsigned n = 0; n < 2048 && f <= fe + st; ++n, f += st) {
+      check(DomainMapF_ToX(&map, f) == ConvertDomainF(f, fs, fe, 0, xMax),
+            "ToX", fs, fe, f);
+    }
+  }
+  for (uint16_t x = 0; x <= xMax + 1u && x <= 255; ++x) {
+    check(DomainMapF_ToF(&map, x) == ConvertDomainF(x, 0, xMax, fs, fe),
+          "ToF", fs, fe, x);
+  }
+}
+
+int main(void) {
+  srand(1);
+  // 27-bit frequencies in 10 Hz units, narrow to full-span ranges
+  const uint32_t F_MAX = (1UL << 27) - 1;
+  for (int i = 0; i < 4000; ++i) {
+    const uint32_t span = i & 1 ? rnd32() % 100000 : rnd32() % F_MAX;
+    const uint32_t fs = rnd32() % (F_MAX - span);
+    run(fs, fs + span, X_MAX[i % 4]);
+  }
+  run(0, F_MAX, 127);
+  run(1000, 1000, 127);  // empty range
+  run(1000, 1001, 127);  // range narrower than screen
+  printf("domainmap: %s\n", fails ? "FAIL" : "ok");
+  return fails != 0;
+}